@@ -0,0 +1,170 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../include/flygpu/flygpu.h"
+#include "../include/flygpu/macros.h"
+#include "measure.h"
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_init.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_video.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define MAX_QUAD3_COUNT 4096
+#define MAX_OMNI_COUNT  1024
+
+/* overlapping quads stand for overdraw, omni lights for shading cost */
+static const Uint32 QUAD3_COUNTS[] = { 64, 512, MAX_QUAD3_COUNT };
+static const Uint32 OMNI_COUNTS[]  = { 0, 32, 256, MAX_OMNI_COUNT };
+
+static void MeasurePath(SDL_Window          *window,
+                        FG_RenderPath        path,
+                        FG_RendererDrawInfo *info,
+                        double              *results);
+
+void MeasurePath(SDL_Window          *window,
+                 FG_RenderPath        path,
+                 FG_RendererDrawInfo *info,
+                 double              *results)
+{
+    FG_Renderer *renderer = FG_CreateRenderer(window, path, false, false);
+    Uint32       i        = 0;
+    Uint32       j        = 0;
+
+    if (!renderer) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    for (i = 0; i != SDL_arraysize(QUAD3_COUNTS); ++i) {
+        for (j = 0; j != SDL_arraysize(OMNI_COUNTS); ++j) {
+            info->quad3_info.count        = QUAD3_COUNTS[i];
+            info->shading_info.omni_count = OMNI_COUNTS[j];
+
+            results[i * SDL_arraysize(OMNI_COUNTS) + j] = MeasureFrames(
+                renderer, info);
+        }
+    }
+
+    FG_DestroyRenderer(renderer);
+}
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    SDL_Window          *window   = NULL;
+    FG_Camera            camera   = FG_DEF_CAMERA;
+    FG_DirectLight       direct   = FG_DEF_DIRECT_LIGHT;
+    FG_OmniLight        *omnis    = SDL_malloc(MAX_OMNI_COUNT * sizeof(*omnis));
+    FG_Quad3            *quad3s   = SDL_malloc(MAX_QUAD3_COUNT * sizeof(*quad3s));
+    Uint32               i        = 0;
+    Uint32               j        = 0;
+    Sint32               width    = 0;
+    Sint32               height   = 0;
+    double               deferred[
+        SDL_arraysize(QUAD3_COUNTS) * SDL_arraysize(OMNI_COUNTS)
+    ];
+    double               forward[SDL_arraysize(deferred)];
+    double              *result   = NULL;
+    FG_RendererDrawInfo  info     = {
+        .camera_count = 1,
+        .cameras      = &camera,
+        .quad3_info   = { .quad3s = quad3s },
+        .shading_info = {
+            .direct_count = 1,
+            .directs      = &direct,
+            .omnis        = omnis
+        }
+    };
+
+    (void)argc;
+    (void)argv;
+
+    if (!omnis || !quad3s) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Out of memory!\n");
+        abort();
+    }
+
+    if (!SDL_InitSubSystem(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    window = SDL_CreateWindow(__FILE__, 1920, 1080, 0);
+    if (!window) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    for (i = 0; i != MAX_QUAD3_COUNT; ++i) {
+        quad3s[i]               = FG_DEF_QUAD3;
+        quad3s[i].transf.transl = (FG_Vec3){
+            .x = SDL_randf() * 4.0F - 2.0F,
+            .y = SDL_randf() * 4.0F - 2.0F,
+            .z = SDL_randf() * -18.0F - 2.0F
+        };
+        quad3s[i].transf.scale  = (FG_Vec2){ .x = 8.0F, .y = 8.0F };
+        quad3s[i].opaque        = true;
+    }
+
+    for (i = 0; i != MAX_OMNI_COUNT; ++i) {
+        omnis[i]        = FG_DEF_OMNI_LIGHT;
+        omnis[i].transl = (FG_Vec3){
+            .x = SDL_randf() * 8.0F - 4.0F,
+            .y = SDL_randf() * 8.0F - 4.0F,
+            .z = SDL_randf() * -20.0F
+        };
+        omnis[i].radius = 2.0F;
+    }
+
+    /* the path is fixed for the lifetime of a renderer */
+    MeasurePath(window, FG_RENDERPATH_DEFERRED, &info, deferred);
+    MeasurePath(window, FG_RENDERPATH_FORWARD, &info, forward);
+
+    SDL_GetWindowSizeInPixels(window, &width, &height);
+
+    SDL_Log("%dx%d, opaque quads, one direct light", width, height);
+    SDL_Log("quads  omnis  deferred ms  forward ms  faster");
+    for (i = 0; i != SDL_arraysize(QUAD3_COUNTS); ++i) {
+        for (j = 0; j != SDL_arraysize(OMNI_COUNTS); ++j) {
+            result = deferred + i * SDL_arraysize(OMNI_COUNTS) + j;
+
+            SDL_Log("%5u  %5u  %11.3f  %10.3f  %s",
+                    QUAD3_COUNTS[i],
+                    OMNI_COUNTS[j],
+                    *result,
+                    forward[result - deferred],
+                    forward[result - deferred] < *result ? "forward" : "deferred");
+        }
+    }
+
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    SDL_free(quad3s);
+    SDL_free(omnis);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../include/flygpu/flygpu.h"
+#include "../include/flygpu/macros.h"
+#include "../src/linalg.h"
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_timer.h>
+
+#include <stdlib.h>
+
+#define QUAD3_COUNT 200000
+#define ITERATIONS  50
+
+typedef struct
+{
+    FG_Mat4      modelmat;
+    FG_Mat4      mvpmat;
+    float        tbnmat[3 * 3];
+    FG_QuadColor color;
+    FG_AABB      coords;
+} LegacyQuad3In;
+
+static void SetLegacyQuad3Ins(const FG_Mat4         *vpmat,
+                              const FG_Quad3 *const *quad3s,
+                              Uint32                 count,
+                              LegacyQuad3In         *quad3ins);
+
+void SetLegacyQuad3Ins(const FG_Mat4         *vpmat,
+                       const FG_Quad3 *const *quad3s,
+                       Uint32                 count,
+                       LegacyQuad3In         *quad3ins)
+{
+    Uint32 i   = 0;
+    float  cos = 0.0F;
+    float  sin = 0.0F;
+
+    for (i = 0; i != count; ++i) {
+        cos = SDL_cosf(quad3s[i]->transf.rotation);
+        sin = SDL_sinf(quad3s[i]->transf.rotation);
+
+        quad3ins[i].modelmat = (FG_Mat4){
+            .m = {
+                [0]  = cos * quad3s[i]->transf.scale.x,
+                [1]  = sin * quad3s[i]->transf.scale.x,
+                [4]  = -sin * quad3s[i]->transf.scale.y,
+                [5]  = cos * quad3s[i]->transf.scale.y,
+                [10] = 1.0F,
+                [12] = quad3s[i]->transf.transl.x,
+                [13] = quad3s[i]->transf.transl.y,
+                [14] = quad3s[i]->transf.transl.z,
+                [15] = 1.0F
+            }
+        };
+        FG_MulMat4s(vpmat, &quad3ins[i].modelmat, &quad3ins[i].mvpmat);
+        quad3ins[i].tbnmat[0] = cos;
+        quad3ins[i].tbnmat[1] = sin;
+        quad3ins[i].tbnmat[2] = 0.0F;
+        quad3ins[i].tbnmat[3] = -sin;
+        quad3ins[i].tbnmat[4] = cos;
+        quad3ins[i].tbnmat[5] = 0.0F;
+        quad3ins[i].tbnmat[6] = 0.0F;
+        quad3ins[i].tbnmat[7] = 0.0F;
+        quad3ins[i].tbnmat[8] = 1.0F;
+        quad3ins[i].color     = quad3s[i]->color;
+        quad3ins[i].coords    = quad3s[i]->coords;
+    }
+}
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    FG_Camera        camera   = FG_DEF_CAMERA;
+    FG_Mat4          projmat  = { 0 };
+    FG_Mat4          viewmat  = { 0 };
+    FG_Mat4          vpmat    = { 0 };
+    FG_Quad3        *quad3s   = SDL_malloc(QUAD3_COUNT * sizeof(*quad3s));
+    const FG_Quad3 **ptrs     = SDL_malloc(QUAD3_COUNT * sizeof(*ptrs));
+    LegacyQuad3In   *legacies = SDL_malloc(QUAD3_COUNT * sizeof(*legacies));
+    FG_Quad3In      *compacts = SDL_malloc(QUAD3_COUNT * sizeof(*compacts));
+    Uint32           i        = 0;
+    Uint8            j        = 0;
+    Uint64           begin    = 0;
+    double           legacy   = 0.0;
+    double           compact  = 0.0;
+
+    (void)argc;
+    (void)argv;
+
+    if (!quad3s || !ptrs || !legacies || !compacts) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Out of memory!\n");
+        abort();
+    }
+
+    camera.transf.transl.z = 10.0F;
+
+    FG_SetProjMat4(&camera.perspective, 16.0F / 9.0F, &projmat);
+    FG_SetViewMat4(&camera.transf, &viewmat);
+    FG_MulMat4s(&projmat, &viewmat, &vpmat);
+
+    for (i = 0; i != QUAD3_COUNT; ++i) {
+        quad3s[i]                 = FG_DEF_QUAD3;
+        quad3s[i].transf.transl   = (FG_Vec3){
+            .x = SDL_randf() * 100.0F - 50.0F,
+            .y = SDL_randf() * 100.0F - 50.0F,
+            .z = SDL_randf() * -100.0F
+        };
+        quad3s[i].transf.rotation = SDL_randf() * 2.0F * FG_PI;
+        quad3s[i].transf.scale    = (FG_Vec2){
+            .x = SDL_randf() * 4.0F,
+            .y = SDL_randf() * 4.0F
+        };
+        ptrs[i]                   = quad3s + i;
+    }
+
+    SetLegacyQuad3Ins(&vpmat, ptrs, QUAD3_COUNT, legacies);
+    begin = SDL_GetPerformanceCounter();
+    for (j = 0; j != ITERATIONS; ++j) {
+        SetLegacyQuad3Ins(&vpmat, ptrs, QUAD3_COUNT, legacies);
+    }
+    legacy = (double)(SDL_GetPerformanceCounter() - begin);
+
+    FG_SetQuad3Ins(quad3s, QUAD3_COUNT, compacts);
+    begin = SDL_GetPerformanceCounter();
+    for (j = 0; j != ITERATIONS; ++j) FG_SetQuad3Ins(quad3s, QUAD3_COUNT, compacts);
+    compact = (double)(SDL_GetPerformanceCounter() - begin);
+
+    legacy  *= 1e9 / (double)SDL_GetPerformanceFrequency() / QUAD3_COUNT / ITERATIONS;
+    compact *= 1e9 / (double)SDL_GetPerformanceFrequency() / QUAD3_COUNT / ITERATIONS;
+
+    SDL_Log(
+        "legacy:  %.2f ns/quad3, %u bytes/quad3",
+        legacy,
+        (Uint32)sizeof(*legacies)
+    );
+    SDL_Log(
+        "compact: %.2f ns/quad3, %u bytes/quad3 (%.2fx faster, %.2fx smaller)",
+        compact,
+        (Uint32)sizeof(*compacts),
+        legacy / compact,
+        (double)sizeof(*legacies) / (double)sizeof(*compacts)
+    );
+
+    SDL_free(compacts);
+    SDL_free(legacies);
+    SDL_free(ptrs);
+    SDL_free(quad3s);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_BENCHMARKS_MEASURE_H
+#define FLYGPU_BENCHMARKS_MEASURE_H
+
+#include "../include/flygpu/flygpu.h"
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_timer.h>
+
+#include <stdlib.h>
+
+#define WARMUP 30
+#define FRAMES 300
+
+/* the average milliseconds per frame once the warmup frames are past */
+static inline double MeasureFrames(FG_Renderer               *renderer,
+                                   const FG_RendererDrawInfo *info)
+{
+    Uint32 i     = 0;
+    Uint64 begin = 0;
+
+    for (i = 0; i != WARMUP + FRAMES; ++i) {
+        if (i == WARMUP) begin = SDL_GetTicksNS();
+
+        if (!FG_RendererDraw(renderer, info)) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+            abort();
+        }
+
+        SDL_PumpEvents();
+    }
+
+    return (double)(SDL_GetTicksNS() - begin) / 1e6 / FRAMES;
+}
+
+#endif /* FLYGPU_BENCHMARKS_MEASURE_H */
@@ -0,0 +1,104 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../include/flygpu/flygpu.h"
+#include "../include/flygpu/macros.h"
+#include "measure.h"
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_init.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_video.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#define QUAD3_COUNT 4096
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    SDL_Window          *window   = NULL;
+    FG_Renderer         *renderer = NULL;
+    FG_Camera            camera   = FG_DEF_CAMERA;
+    FG_Quad3            *quad3s   = SDL_malloc(QUAD3_COUNT * sizeof(*quad3s));
+    Uint32               i        = 0;
+    double               tested   = 0.0;
+    double               opaque   = 0.0;
+    FG_RendererDrawInfo  info     = {
+        .camera_count = 1,
+        .cameras      = &camera,
+        .quad3_info   = { .count = QUAD3_COUNT, .quad3s = quad3s }
+    };
+
+    (void)argc;
+    (void)argv;
+
+    if (!quad3s) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "Out of memory!\n");
+        abort();
+    }
+
+    if (!SDL_InitSubSystem(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    window = SDL_CreateWindow(__FILE__, 1280, 720, 0);
+    if (!window) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    renderer = FG_CreateRenderer(window, FG_RENDERPATH_DEFERRED, false, false);
+    if (!renderer) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
+    for (i = 0; i != QUAD3_COUNT; ++i) {
+        quad3s[i]               = FG_DEF_QUAD3;
+        quad3s[i].transf.transl = (FG_Vec3){
+            .x = SDL_randf() * 4.0F - 2.0F,
+            .y = SDL_randf() * 4.0F - 2.0F,
+            .z = SDL_randf() * -18.0F - 2.0F
+        };
+        quad3s[i].transf.scale  = (FG_Vec2){ .x = 8.0F, .y = 8.0F };
+    }
+
+    tested = MeasureFrames(renderer, &info);
+
+    for (i = 0; i != QUAD3_COUNT; ++i) quad3s[i].opaque = true;
+
+    opaque = MeasureFrames(renderer, &info);
+
+    SDL_Log("alpha-tested: %.3f ms/frame", tested);
+    SDL_Log("opaque:       %.3f ms/frame (%.2fx faster)", opaque, tested / opaque);
+
+    FG_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    SDL_free(quad3s);
+    return EXIT_SUCCESS;
+}
@@ -51,21 +51,23 @@ static const char *ALBEDOS[3] = {
 
 Sint32 main(Sint32 argc, char **argv)
 {
-    SDL_Window     *window                            = NULL;
-    FG_Renderer    *renderer                          = NULL;
-    SDL_Surface    *surface                           = NULL;
-    FG_Environment  env                               = FG_DEF_ENVIRONMENT;
-    FG_Camera       cameras[2]                        = {
+    SDL_Window     *window                          = NULL;
+    FG_Renderer    *renderer                        = NULL;
+    SDL_Surface    *surface                         = NULL;
+    FG_Environment  env                             = FG_DEF_ENVIRONMENT;
+    FG_Camera       cameras[2]                      = {
         FG_DEF_CAMERA,
         FG_DEF_CAMERA
     };
-    const bool     *keys                              = NULL;
-    Uint8           i                                 = 0;
-    FG_Material     materials[SDL_arraysize(ALBEDOS)] = { 0 };
-    FG_Quad3        quad3s[SDL_arraysize(materials)]  = { 0 };
-    float           delta                             = 0;
-    Uint64          curr_tick                         = 0;
-    Uint64          last_tick                         = 0;
+    const bool     *keys                            = NULL;
+    Uint8           i                               = 0;
+    SDL_Surface    *sprites[SDL_arraysize(ALBEDOS)] = { 0 };
+    FG_AtlasSprite  coords[SDL_arraysize(sprites)]  = { 0 };
+    FG_Material     material                        = { 0 };
+    FG_Quad3        quad3s[SDL_arraysize(sprites)]  = { 0 };
+    float           delta                           = 0;
+    Uint64          curr_tick                       = 0;
+    Uint64          last_tick                       = 0;
 
     (void)argc;
     (void)argv;
@@ -86,7 +88,7 @@ Sint32 main(Sint32 argc, char **argv)
         abort();
     }
 
-    renderer = FG_CreateRenderer(window, true, true);
+    renderer = FG_CreateRenderer(window, FG_RENDERPATH_DEFERRED, true, true);
     if (!renderer) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
         abort();
@@ -98,7 +100,7 @@ Sint32 main(Sint32 argc, char **argv)
         abort();
     }
 
-    if (!FG_RendererCreateTexture(renderer, surface, false, &env.texture) ||
+    if (!FG_RendererEnqueueTexture(renderer, surface, false, &env.texture) ||
         !env.texture
     ) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
@@ -112,35 +114,50 @@ Sint32 main(Sint32 argc, char **argv)
 
     cameras[1].viewport.tl.x = 0.5F;
     cameras[1].env           = &env;
+    cameras[1].shading       = FG_SHADING_HALF;
 
     keys = SDL_GetKeyboardState(NULL);
 
-    for (i = 0; i != SDL_arraysize(quad3s); ++i) {
-        quad3s[i]                 = FG_DEF_QUAD3;
-        quad3s[i].transf.transl.z = (float)(i + 1) * -5.0F;
-
-        surface = SDL_LoadPNG(ALBEDOS[i]);
-        if (!surface) {
+    for (i = 0; i != SDL_arraysize(sprites); ++i) {
+        sprites[i] = SDL_LoadPNG(ALBEDOS[i]);
+        if (!sprites[i]) {
             SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
             abort();
         }
+    }
 
-        quad3s[i].transf.scale = (FG_Vec2){
-            .x = (float)surface->w * 0.01F,
-            .y = (float)surface->h * 0.01F
-        };
+    /* the sprites share one atlas, so every quad draws in the same batch */
+    if (!FG_RendererEnqueueAtlas(
+        renderer,
+        (const SDL_Surface *const *)sprites,
+        SDL_arraysize(sprites),
+        512,
+        false,
+        &material.maps.albedo,
+        coords) ||
+        !material.maps.albedo
+    ) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
 
-        if (!FG_RendererCreateTexture(
-            renderer, surface, false, &materials[i].maps.albedo) ||
-            !materials[i].maps.albedo
-        ) {
-            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
-            abort();
-        }
+    for (i = 0; i != SDL_arraysize(quad3s); ++i) {
+        quad3s[i]                 = FG_DEF_QUAD3;
+        quad3s[i].transf.transl.z = (float)(i + 1) * -5.0F;
+        quad3s[i].transf.scale    = (FG_Vec2){
+            .x = (float)sprites[i]->w * 0.01F,
+            .y = (float)sprites[i]->h * 0.01F
+        };
+        quad3s[i].material        = &material;
+        quad3s[i].coords          = coords[i].coords;
+        quad3s[i].layer           = coords[i].layer;
 
-        SDL_DestroySurface(surface);
+        SDL_DestroySurface(sprites[i]);
+    }
 
-        quad3s[i].material = materials + i;
+    if (!FG_RendererSubmitUploads(renderer, NULL)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
     }
 
     while (!SDL_HasEvent(SDL_EVENT_QUIT)) {
@@ -162,6 +179,8 @@ Sint32 main(Sint32 argc, char **argv)
         cameras[1].transf.rotation += (float)(keys[SDL_SCANCODE_U]
                                     - keys[SDL_SCANCODE_O]) * delta * ROLL_SPEED;
 
+        cameras[1].unlit = keys[SDL_SCANCODE_TAB];
+
         if (!FG_RendererDraw(
             renderer,
             &(FG_RendererDrawInfo){
@@ -181,9 +200,7 @@ Sint32 main(Sint32 argc, char **argv)
         last_tick = curr_tick;
     }
 
-    for (i = 0; i != SDL_arraysize(materials); ++i) {
-        FG_RendererDestroyTexture(renderer, materials[i].maps.albedo);
-    }
+    FG_RendererDestroyTexture(renderer, material.maps.albedo);
     FG_RendererDestroyTexture(renderer, env.texture);
     FG_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
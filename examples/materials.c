@@ -96,7 +96,7 @@ Sint32 main(Sint32 argc, char **argv)
         abort();
     }
 
-    renderer = FG_CreateRenderer(window, true, true);
+    renderer = FG_CreateRenderer(window, FG_RENDERPATH_DEFERRED, true, true);
     if (!renderer) {
         SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
         abort();
@@ -109,13 +109,14 @@ Sint32 main(Sint32 argc, char **argv)
 
     for (i = 0; i != SDL_arraysize(MATERIALS); ++i) {
         for (j = 0; j != SDL_arraysize(MATERIALS[i]); ++j) {
+            /* missing textures are left to the renderer's fallback */
             surface = SDL_LoadPNG(MATERIALS[i][j]);
             if (!surface) {
-                SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
-                abort();
+                SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "%s\n", SDL_GetError());
+                continue;
             }
 
-            if (!FG_RendererCreateTexture(
+            if (!FG_RendererEnqueueTexture(
                 renderer, surface, i != 0, materials[i].iter + j) ||
                 !materials[i].iter[j]
             ) {
@@ -127,6 +128,11 @@ Sint32 main(Sint32 argc, char **argv)
         }
     }
 
+    if (!FG_RendererSubmitUploads(renderer, NULL)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        abort();
+    }
+
     quad3.transf.transl.z = -1.0F;
     quad3.transf.scale    = (FG_Vec2){ .x = 0.9F, .y = 0.9F };
     quad3.material        = materials;
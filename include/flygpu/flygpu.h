@@ -25,6 +25,7 @@
 #define FLYGPU_FLYGPU_H
 
 #include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_iostream.h>
 #include <SDL3/SDL_stdinc.h>
 #include <SDL3/SDL_surface.h>
 #include <SDL3/SDL_video.h>
@@ -86,15 +87,24 @@ typedef struct
     FG_Vec2 scale;
 } FG_Transform3;
 
+typedef enum
+{
+    FG_SHADING_FULL,
+    FG_SHADING_HALF,
+    FG_SHADING_QUARTER
+} FG_ShadingResolution;
+
 typedef struct
 {
-    Sint32          priority;
-    FG_AABB         viewport;
-    FG_Perspective  perspective;
-    FG_Environment *env;
-    FG_Transform3   transf;
-    Uint32          mask;
-    Uint32          padding;
+    Sint32                priority;
+    FG_AABB               viewport;
+    FG_Perspective        perspective;
+    FG_Environment       *env;
+    FG_Transform3         transf;
+    Uint32                mask;
+    FG_ShadingResolution  shading;
+    bool                  unlit;
+    Uint8                 padding[7];
 } FG_Camera;
 
 typedef union
@@ -115,7 +125,10 @@ typedef struct
     FG_QuadColor       color;
     FG_AABB            coords;
     Uint32             mask;
-    Uint32             padding;
+    Uint32             layer;
+    /* per quad, as one atlas material can hold both opaque and cut-out sprites */
+    bool               opaque;
+    Uint8              padding[7];
 } FG_Quad3;
 
 typedef struct
@@ -149,6 +162,31 @@ typedef struct
     const FG_OmniLight   *omnis;
 } FG_ShadingStageDrawInfo;
 
+typedef enum
+{
+    FG_RENDERPATH_DEFERRED,
+    FG_RENDERPATH_FORWARD
+} FG_RenderPath;
+
+typedef enum
+{
+    FG_LIGHTING_TILED,
+    FG_LIGHTING_VOLUMES
+} FG_Lighting;
+
+typedef enum
+{
+    FG_GBUFFER_COMPACT,
+    FG_GBUFFER_FULL
+} FG_GBufferLayout;
+
+typedef struct
+{
+    Uint32 visible_quad3_count;
+    Uint32 culled_quad3_count;
+    float  resolution_scale;
+} FG_RendererStats;
+
 typedef struct
 {
     FG_Vec3                  color;
@@ -156,19 +194,117 @@ typedef struct
     const FG_Camera         *cameras;
     FG_Quad3StageDrawInfo    quad3_info;
     FG_ShadingStageDrawInfo  shading_info;
+    FG_RendererStats        *stats;
 } FG_RendererDrawInfo;
 
+typedef enum
+{
+    FG_COMPRESSION_BC3,
+    FG_COMPRESSION_BC5,
+    FG_COMPRESSION_BC7
+} FG_Compression;
+
+typedef struct
+{
+    FG_Compression  compression;
+    Uint32          width;
+    Uint32          height;
+    Uint32          level_count;
+    const void     *levels;
+} FG_CompressedImage;
+
+typedef struct
+{
+    FG_AABB coords;
+    Uint32  layer;
+} FG_AtlasSprite;
+
+typedef struct FG_Pack FG_Pack;
+
 typedef struct FG_Renderer FG_Renderer;
 
-SDL_DECLSPEC FG_Renderer * SDLCALL FG_CreateRenderer(SDL_Window *window,
-                                                     bool        vsync,
-                                                     bool        debug);
+SDL_DECLSPEC FG_Renderer * SDLCALL FG_CreateRenderer(SDL_Window    *window,
+                                                     FG_RenderPath  path,
+                                                     bool           vsync,
+                                                     bool           debug);
 
 SDL_DECLSPEC bool SDLCALL FG_RendererCreateTexture(FG_Renderer        *self,
                                                    const SDL_Surface  *surface,
                                                    bool                mipmaps,
                                                    SDL_GPUTexture    **texture);
 
+SDL_DECLSPEC bool SDLCALL FG_RendererCreateTextureArray(
+    FG_Renderer               *self,
+    const SDL_Surface *const  *surfaces,
+    Uint32                     count,
+    bool                       mipmaps,
+    SDL_GPUTexture           **texture);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererCreateCompressedTexture(
+    FG_Renderer               *self,
+    const FG_CompressedImage  *image,
+    SDL_GPUTexture           **texture);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererCreateAtlas(
+    FG_Renderer               *self,
+    const SDL_Surface *const  *surfaces,
+    Uint32                     count,
+    Uint32                     size,
+    bool                       mipmaps,
+    SDL_GPUTexture           **texture,
+    FG_AtlasSprite            *sprites);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererEnqueueTexture(FG_Renderer        *self,
+                                                    const SDL_Surface  *surface,
+                                                    bool                mipmaps,
+                                                    SDL_GPUTexture    **texture);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererEnqueueTextureArray(
+    FG_Renderer               *self,
+    const SDL_Surface *const  *surfaces,
+    Uint32                     count,
+    bool                       mipmaps,
+    SDL_GPUTexture           **texture);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererEnqueueCompressedTexture(
+    FG_Renderer               *self,
+    const FG_CompressedImage  *image,
+    SDL_GPUTexture           **texture);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererEnqueueAtlas(
+    FG_Renderer               *self,
+    const SDL_Surface *const  *surfaces,
+    Uint32                     count,
+    Uint32                     size,
+    bool                       mipmaps,
+    SDL_GPUTexture           **texture,
+    FG_AtlasSprite            *sprites);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererSubmitUploads(FG_Renderer *self, Uint64 *token);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererQueryUploads(FG_Renderer *self, Uint64 token);
+
+SDL_DECLSPEC bool SDLCALL FG_RendererCreateQuad3(FG_Renderer    *self,
+                                                 const FG_Quad3 *quad3,
+                                                 Uint32         *handle);
+
+SDL_DECLSPEC void SDLCALL FG_RendererUpdateQuad3(FG_Renderer    *self,
+                                                 Uint32          handle,
+                                                 const FG_Quad3 *quad3);
+
+SDL_DECLSPEC void SDLCALL FG_RendererDestroyQuad3(FG_Renderer *self, Uint32 handle);
+
+SDL_DECLSPEC void SDLCALL FG_RendererSetLighting(FG_Renderer *self,
+                                                 FG_Lighting  lighting);
+
+SDL_DECLSPEC void SDLCALL FG_RendererSetGBufferLayout(FG_Renderer      *self,
+                                                      FG_GBufferLayout  layout);
+
+SDL_DECLSPEC void SDLCALL FG_RendererSetDynamicResolution(FG_Renderer *self,
+                                                          float        target_time,
+                                                          float        min_scale,
+                                                          float        max_scale);
+
 SDL_DECLSPEC bool SDLCALL FG_RendererDraw(FG_Renderer               *self,
                                           const FG_RendererDrawInfo *info);
 
@@ -177,6 +313,19 @@ SDL_DECLSPEC void SDLCALL FG_RendererDestroyTexture(FG_Renderer    *self,
 
 SDL_DECLSPEC void SDLCALL FG_DestroyRenderer(FG_Renderer *self);
 
+SDL_DECLSPEC FG_CompressedImage * SDLCALL FG_LoadDDS_IO(SDL_IOStream *src,
+                                                       bool          closeio);
+
+SDL_DECLSPEC FG_CompressedImage * SDLCALL FG_LoadDDS(const char *file);
+
+SDL_DECLSPEC FG_Pack * SDLCALL FG_OpenPack(const char *file);
+
+SDL_DECLSPEC bool SDLCALL FG_PackGetImage(const FG_Pack      *self,
+                                          const char         *name,
+                                          FG_CompressedImage *image);
+
+SDL_DECLSPEC void SDLCALL FG_ClosePack(FG_Pack *self);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
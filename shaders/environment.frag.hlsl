@@ -28,12 +28,12 @@ struct Input
     noperspective   float2 TexCoord : TEXCOORD4;
 };
 
-Texture2D<float4> tTexture : register(t0, space2);
-SamplerState      sTexture : register(s0, space2);
+Texture2DArray<float4> tTexture : register(t0, space2);
+SamplerState           sTexture : register(s0, space2);
 
 float4 main(const Input input) : SV_Target0
 {
-    float4 output = tTexture.Sample(sTexture, input.TexCoord);
+    float4 output = tTexture.Sample(sTexture, float3(input.TexCoord, 0.0F));
     if (output.a <= 0.0F) discard;
 
     const float2 colorCoord  = frac(input.TexCoord);
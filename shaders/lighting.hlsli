@@ -0,0 +1,144 @@
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+struct DirectLight
+{
+    float3 Direction;
+    uint   Padding0;
+    float3 Color;
+    uint   Mask;
+};
+
+struct OmniLight
+{
+    float3 Position;
+    float  Radius;
+    float3 Color;
+    uint   Mask;
+};
+
+struct UniformBuffer
+{
+    float4x4 InvVP;
+    float4   Viewport;
+    float3   Origo;
+    uint     DirectsSize;
+    float3   Ambient;
+    uint     Mask;
+    uint2    TileOrigin;
+    uint2    TileCount;
+    uint     TileOffset;
+    float    Shine;
+    float    Scale;
+    uint     Padding0;
+};
+
+struct Lighting
+{
+    float3 Diffuse;
+    float3 Specular;
+};
+
+static const uint TILE_SIZE = 32;
+
+/* the light buffers follow the samplers, so their registers are up to the includer */
+#ifdef DIRECTS_REGISTER
+ByteAddressBuffer             bDirects : register(DIRECTS_REGISTER, space2);
+ByteAddressBuffer             bOmnis   : register(OMNIS_REGISTER, space2);
+ByteAddressBuffer             bTiles   : register(TILES_REGISTER, space2);
+ByteAddressBuffer             bIndices : register(INDICES_REGISTER, space2);
+#endif /* DIRECTS_REGISTER */
+ConstantBuffer<UniformBuffer> cUniform : register(b0, space3);
+
+float3 GetPosition(const float2 pixel, const float depth)
+{
+    const float2 ndc      = (pixel - cUniform.Viewport.xy) / cUniform.Viewport.zw
+                          * float2(2.0F, -2.0F) + float2(-1.0F, 1.0F);
+    const float4 position = mul(cUniform.InvVP, float4(ndc, depth, 1.0F));
+
+    return position.xyz / position.w;
+}
+
+#ifdef DIRECTS_REGISTER
+void AddOmni(inout Lighting lighting,
+             const OmniLight light,
+             const float3    position,
+             const float3    normal,
+             const float3    viewDir)
+{
+          float3 lightDir = light.Position - position;
+    const float  distance = length(lightDir);
+
+    if (light.Radius <= distance || distance == 0.0F) return;
+
+                lightDir /= distance;
+    const float NdotL     = dot(normal, lightDir);
+
+    if (NdotL < 0.0F) return;
+
+    const float attenuation = distance / light.Radius;
+    const float falloff     = 1.0F - attenuation * attenuation;
+
+    lighting.Diffuse  += NdotL * light.Color * falloff;
+    lighting.Specular += pow(
+        max(dot(normal, normalize(lightDir + viewDir)), 0.0F), cUniform.Shine
+    ) * light.Color * falloff;
+}
+
+/* ambient, every direct light and the omni lights binned to the pixel's tile */
+Lighting GetLighting(const float2 pixel, const float depth, const float3 normal)
+{
+    Lighting lighting = { cUniform.Ambient, 0.0F.xxx };
+
+    for (uint i = 0; i != cUniform.DirectsSize; i += sizeof(DirectLight)) {
+        const DirectLight light = bDirects.Load<DirectLight>(i);
+        if (!(light.Mask & cUniform.Mask)) continue;
+
+        const float NdotL = dot(normal, -light.Direction);
+
+        if (0.0F <= NdotL) {
+            lighting.Diffuse  += NdotL * light.Color;
+            lighting.Specular += pow(NdotL, cUniform.Shine) * light.Color;
+        }
+    }
+
+    const uint2 tile = (uint2(pixel) - cUniform.TileOrigin) / TILE_SIZE;
+    if (any(cUniform.TileCount <= tile)) return lighting;
+
+    const float3 position = GetPosition(pixel, depth);
+    const float3 viewDir  = normalize(cUniform.Origo - position);
+    const uint2  range    = bTiles.Load2(
+        (cUniform.TileOffset + tile.y * cUniform.TileCount.x + tile.x) * 8
+    );
+
+    for (uint j = range.x; j != range.x + range.y; ++j) {
+        AddOmni(
+            lighting,
+            bOmnis.Load<OmniLight>(bIndices.Load(j * 4) * sizeof(OmniLight)),
+            position,
+            normal,
+            viewDir
+        );
+    }
+
+    return lighting;
+}
+#endif /* DIRECTS_REGISTER */
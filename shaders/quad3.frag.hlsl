@@ -22,52 +22,126 @@
 struct Input
 {
     nointerpolation float3x3 TBN      : TEXCOORD0;
-    noperspective   float3   Position : TEXCOORD3;
-    nointerpolation float3   ColorTL  : TEXCOORD4;
-    nointerpolation float3   ColorBL  : TEXCOORD5;
-    nointerpolation float3   ColorBR  : TEXCOORD6;
-    nointerpolation float3   ColorTR  : TEXCOORD7;
-    noperspective   float2   TexCoord : TEXCOORD8;
+    nointerpolation float3   ColorTL  : TEXCOORD3;
+    nointerpolation float3   ColorBL  : TEXCOORD4;
+    nointerpolation float3   ColorBR  : TEXCOORD5;
+    nointerpolation float3   ColorTR  : TEXCOORD6;
+    noperspective   float2   TexCoord : TEXCOORD7;
+    nointerpolation uint     Layer    : TEXCOORD8;
 };
 
 struct Output
 {
-    float4 Position : SV_Target0;
-    float4 Normal   : SV_Target1;
-    float4 Specular : SV_Target2;
-    float4 Albedo   : SV_Target3;
+#if defined(FORWARD) || defined(UNLIT)
+    float4 Color    : SV_Target0;
+#else /* FORWARD || UNLIT */
+    float4 Normal   : SV_Target0;
+    float4 Specular : SV_Target1;
+    float4 Albedo   : SV_Target2;
+#endif /* FORWARD || UNLIT */
 };
 
-Texture2D<float4> tAlbedo   : register(t0, space2);
-SamplerState      sAlbedo   : register(s0, space2);
-Texture2D<float4> tSpecular : register(t1, space2);
-SamplerState      sSpecular : register(s1, space2);
-Texture2D<float4> tNormal   : register(t2, space2);
-SamplerState      sNormal   : register(s2, space2);
+Texture2DArray<float4> tAlbedo   : register(t0, space2);
+SamplerState           sAlbedo   : register(s0, space2);
+Texture2DArray<float4> tSpecular : register(t1, space2);
+SamplerState           sSpecular : register(s1, space2);
+Texture2DArray<float4> tNormal   : register(t2, space2);
+SamplerState           sNormal   : register(s2, space2);
 
+float3 GetColor(const Input input)
+{
+    const float2 colorCoord = frac(input.TexCoord);
+
+    return lerp(
+        lerp(input.ColorTL, input.ColorTR, colorCoord.x),
+        lerp(input.ColorBL, input.ColorBR, colorCoord.x),
+        colorCoord.y
+    );
+}
+
+/* z is rebuilt from xy so two channel BC5 normal maps read like RGBA ones */
+float3 GetNormal(const Input input, const float3 texCoord)
+{
+    const float2 normal = tNormal.Sample(sNormal, texCoord).xy * 2.0F - 1.0F;
+
+    return mul(float3(normal, sqrt(saturate(1.0F - dot(normal, normal)))), input.TBN);
+}
+
+#if defined(UNLIT)
 Output main(const Input input)
 {
     Output output;
 
-    output.Albedo = tAlbedo.Sample(sAlbedo, input.TexCoord);
-    if (output.Albedo.a <= 0.0F) discard;
+    output.Color = tAlbedo.Sample(sAlbedo, float3(input.TexCoord, input.Layer));
+#ifndef OPAQUE
+    if (output.Color.a <= 0.0F) discard;
+#endif /* OPAQUE */
 
-    output.Position = float4(input.Position, 1.0F);
-    output.Normal   = float4(
-        mul(tNormal.Sample(sNormal, input.TexCoord).rgb * 2.0F - 1.0F, input.TBN),
-        1.0F
+    output.Color = float4(output.Color.rgb * GetColor(input), 1.0F);
+
+    return output;
+}
+#elif defined(FORWARD)
+#define DIRECTS_REGISTER t3
+#define OMNIS_REGISTER   t4
+#define TILES_REGISTER   t5
+#define INDICES_REGISTER t6
+
+#include "lighting.hlsli"
+
+Output main(const Input input, const float4 Position : SV_Position)
+{
+    Output       output;
+    const float3 texCoord = float3(input.TexCoord, input.Layer);
+    const float4 albedo   = tAlbedo.Sample(sAlbedo, texCoord);
+#ifndef OPAQUE
+    if (albedo.a <= 0.0F) discard;
+#endif /* OPAQUE */
+
+    /* lit in place, the fragment depth stands in for the sampled G-buffer depth */
+    const Lighting lighting = GetLighting(
+        Position.xy,
+        Position.z,
+        normalize(GetNormal(input, texCoord))
     );
 
-    const float2 colorCoord = frac(input.TexCoord);
-    const float3 color      = lerp(
-        lerp(input.ColorTL, input.ColorTR, colorCoord.x),
-        lerp(input.ColorBL, input.ColorBR, colorCoord.x),
-        colorCoord.y
+    output.Color = float4(
+        GetColor(input) * (albedo.rgb * lighting.Diffuse
+                           + tSpecular.Sample(sSpecular, texCoord).rgb
+                           * lighting.Specular),
+        1.0F
     );
 
+    return output;
+}
+#else /* UNLIT || FORWARD */
+float2 EncodeNormal(const float3 normal)
+{
+    const float3 octant = normal / dot(abs(normal), 1.0F);
+
+    if (0.0F <= octant.z) return octant.xy;
+
+    return (1.0F - abs(octant.yx)) * select(octant.xy >= 0.0F, 1.0F, -1.0F);
+}
+
+Output main(const Input input)
+{
+    Output       output;
+    const float3 texCoord = float3(input.TexCoord, input.Layer);
+
+    output.Albedo = tAlbedo.Sample(sAlbedo, texCoord);
+#ifndef OPAQUE
+    if (output.Albedo.a <= 0.0F) discard;
+#endif /* OPAQUE */
+
+    output.Normal = float4(EncodeNormal(GetNormal(input, texCoord)), 0.0F, 1.0F);
+
+    const float3 color = GetColor(input);
+
     output.Specular    = float4(
-        color * tSpecular.Sample(sSpecular, input.TexCoord).rgb, 1.0F);
+        color * tSpecular.Sample(sSpecular, texCoord).rgb, 1.0F);
     output.Albedo.rgb *= color;
 
     return output;
 }
+#endif /* UNLIT || FORWARD */
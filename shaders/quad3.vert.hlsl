@@ -21,58 +21,88 @@
 
 struct Input
 {
-    float4x4 MODEL       : TEXCOORD0;
-    float4x4 MVP         : TEXCOORD4;
-    float3x3 TBN         : TEXCOORD8;
-    float3   ColorTL     : TEXCOORD11;
-    float3   ColorBL     : TEXCOORD12;
-    float3   ColorBR     : TEXCOORD13;
-    float3   ColorTR     : TEXCOORD14;
-    float4   TexCoord    : TEXCOORD15;
-    uint     VertexIndex : SV_VertexID;
+    uint Instance    : TEXCOORD0;
+    uint VertexIndex : SV_VertexID;
+};
+
+struct Quad3
+{
+    float3 Translation;
+    float  Rotation;
+    float2 Scale;
+    uint2  ColorTL;
+    uint2  ColorBL;
+    uint2  ColorBR;
+    uint2  ColorTR;
+    float4 TexCoord;
+    uint   Layer;
+};
+
+struct UniformBuffer
+{
+    float4x4 VP;
 };
 
 struct Output
 {
     float3x3 TBN            : TEXCOORD0;
-    float3   Position       : TEXCOORD3;
-    float3   ColorTL        : TEXCOORD4;
-    float3   ColorBL        : TEXCOORD5;
-    float3   ColorBR        : TEXCOORD6;
-    float3   ColorTR        : TEXCOORD7;
-    float2   TexCoord       : TEXCOORD8;
+    float3   ColorTL        : TEXCOORD3;
+    float3   ColorBL        : TEXCOORD4;
+    float3   ColorBR        : TEXCOORD5;
+    float3   ColorTR        : TEXCOORD6;
+    float2   TexCoord       : TEXCOORD7;
+    uint     Layer          : TEXCOORD8;
     float4   VertexPosition : SV_Position;
 };
 
+ByteAddressBuffer             bQuad3s  : register(t0, space0);
+ConstantBuffer<UniformBuffer> cUniform : register(b0, space1);
+
 static const uint   INDICES[6]   = { 0, 1, 3, 1, 2, 3 };
-static const float4 POSITIONS[4] = {
-    float4(-0.5F, 0.5F, 0.0F, 1.0F),
-    float4(-0.5F, -0.5F, 0.0F, 1.0F),
-    float4(0.5F, -0.5F, 0.0F, 1.0F),
-    float4(0.5F, 0.5F, 0.0F, 1.0F)
+static const float2 POSITIONS[4] = {
+    float2(-0.5F, 0.5F),
+    float2(-0.5F, -0.5F),
+    float2(0.5F, -0.5F),
+    float2(0.5F, 0.5F)
 };
 
+float3 UnpackColor(const uint2 color)
+{
+    return float3(f16tof32(color.x), f16tof32(color.x >> 16), f16tof32(color.y));
+}
+
 Output main(const Input input)
 {
-    Output output;
+    Output      output;
+    const Quad3 quad3 = bQuad3s.Load<Quad3>(input.Instance * sizeof(Quad3));
+
+    float sine;
+    float cosine;
+    sincos(quad3.Rotation, sine, cosine);
 
-    output.TBN = input.TBN;
+    output.TBN = float3x3(cosine, sine, 0.0F, -sine, cosine, 0.0F, 0.0F, 0.0F, 1.0F);
 
     const uint   i        = INDICES[input.VertexIndex];
-    const float4 position = POSITIONS[i];
+    const float2 corner   = POSITIONS[i] * quad3.Scale;
+    const float4 position = float4(
+        cosine * corner.x - sine * corner.y + quad3.Translation.x,
+        sine * corner.x + cosine * corner.y + quad3.Translation.y,
+        quad3.Translation.z,
+        1.0F
+    );
 
-    output.Position = mul(position, input.MODEL).xyz;
-    output.ColorTL  = input.ColorTL;
-    output.ColorBL  = input.ColorBL;
-    output.ColorBR  = input.ColorBR;
-    output.ColorTR  = input.ColorTR;
+    output.ColorTL = UnpackColor(quad3.ColorTL);
+    output.ColorBL = UnpackColor(quad3.ColorBL);
+    output.ColorBR = UnpackColor(quad3.ColorBR);
+    output.ColorTR = UnpackColor(quad3.ColorTR);
     switch (i) {
-    case 0: output.TexCoord = input.TexCoord.xy; break;
-    case 1: output.TexCoord = input.TexCoord.xw; break;
-    case 2: output.TexCoord = input.TexCoord.zw; break;
-    case 3: output.TexCoord = input.TexCoord.zy; break;
+    case 0: output.TexCoord = quad3.TexCoord.xy; break;
+    case 1: output.TexCoord = quad3.TexCoord.xw; break;
+    case 2: output.TexCoord = quad3.TexCoord.zw; break;
+    case 3: output.TexCoord = quad3.TexCoord.zy; break;
     }
-    output.VertexPosition = mul(position, input.MVP);
+    output.Layer          = quad3.Layer;
+    output.VertexPosition = mul(cUniform.VP, position);
 
     return output;
 }
@@ -19,90 +19,187 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
-struct DirectLight
+#ifdef LOWRES
+struct Output
 {
-    float3 Direction;
-    uint   Padding0;
-    float3 Color;
-    uint   Padding1;
+    float4 Diffuse  : SV_Target0;
+    float4 Specular : SV_Target1;
 };
-
-struct OmniLight
+#else /* LOWRES */
+typedef float4 Output;
+#endif /* LOWRES */
+
+Texture2D<float>  tDepth         : register(t0, space2);
+SamplerState      sDepth         : register(s0, space2);
+Texture2D<float4> tNormal        : register(t1, space2);
+SamplerState      sNormal        : register(s1, space2);
+Texture2D<float4> tSpecular      : register(t2, space2);
+SamplerState      sSpecular      : register(s2, space2);
+Texture2D<float4> tAlbedo        : register(t3, space2);
+SamplerState      sAlbedo        : register(s3, space2);
+#ifdef UPSAMPLE
+Texture2D<float4> tLightDiffuse  : register(t4, space2);
+SamplerState      sLightDiffuse  : register(s4, space2);
+Texture2D<float4> tLightSpecular : register(t5, space2);
+SamplerState      sLightSpecular : register(s5, space2);
+#else /* UPSAMPLE */
+#define DIRECTS_REGISTER t4
+#define OMNIS_REGISTER   t5
+#define TILES_REGISTER   t6
+#define INDICES_REGISTER t7
+#endif /* UPSAMPLE */
+
+#include "lighting.hlsli"
+
+float2 GetTexCoord(const float2 pixel)
 {
-    float3 Position;
-    float  Radius;
-    float3 Color;
-    uint   Padding0;
-};
+    float2 size;
+    tDepth.GetDimensions(size.x, size.y);
 
-struct UniformBuffer
+    return pixel / size;
+}
+
+/* the full resolution pixel a possibly scaled down fragment stands for */
+float2 GetPixel(const float2 position)
 {
-    float3 Origo;
-    uint   DirectsSize;
-    float3 Ambient;
-    uint   OmnisSize;
-    float3 Padding0;
-    float  Shine;
-};
+    return floor(position) * cUniform.Scale + 0.5F;
+}
 
-Texture2D<float4>             tPosition : register(t0, space2);
-SamplerState                  sPosition : register(s0, space2);
-Texture2D<float4>             tNormal   : register(t1, space2);
-SamplerState                  sNormal   : register(s1, space2);
-Texture2D<float4>             tSpecular : register(t2, space2);
-SamplerState                  sSpecular : register(s2, space2);
-Texture2D<float4>             tAlbedo   : register(t3, space2);
-SamplerState                  sAlbedo   : register(s3, space2);
-ByteAddressBuffer             bDirects  : register(t4, space2);
-ByteAddressBuffer             bOmnis    : register(t5, space2);
-ConstantBuffer<UniformBuffer> cUniform  : register(b0, space3);
-
-float4 main(const noperspective float2 TexCoord : TEXCOORD0) : SV_Target0
+float3 DecodeNormal(const float2 octant)
 {
-    float3 normal = tNormal.Sample(sNormal, TexCoord).xyz;
-    if (all(normal == 0.0F)) discard;
+          float3 normal = float3(octant, 1.0F - dot(abs(octant), 1.0F));
+    const float  fold   = saturate(-normal.z);
+
+    normal.xy += select(normal.xy >= 0.0F, -fold, fold);
 
-                 normal   = normalize(normal);
-    const float3 albedo   = tAlbedo.Sample(sAlbedo, TexCoord).rgb;
-    float3       output   = albedo * cUniform.Ambient;
-    const float3 specular = tSpecular.Sample(sSpecular, TexCoord).rgb;
+    return normalize(normal);
+}
 
-    for (uint i = 0; i != cUniform.DirectsSize; i += sizeof(DirectLight)) {
-        const DirectLight light = bDirects.Load<DirectLight>(i);
-        const float       NdotL = dot(normal, normalize(-light.Direction));
+Output Compose(const Lighting lighting, const float2 texCoord)
+{
+#ifdef LOWRES
+    const Output output = {
+        float4(lighting.Diffuse, 1.0F), float4(lighting.Specular, 1.0F)
+    };
+
+    return output;
+#else /* LOWRES */
+    return float4(
+        tAlbedo.Sample(sAlbedo, texCoord).rgb * lighting.Diffuse
+        + tSpecular.Sample(sSpecular, texCoord).rgb * lighting.Specular,
+        1.0F
+    );
+#endif /* LOWRES */
+}
 
-        if (0.0F <= NdotL) {
-            output += albedo * NdotL * light.Color
-                    + specular * pow(NdotL, cUniform.Shine) * light.Color;
+#ifdef UPSAMPLE
+Output main(const float4 Position : SV_Position)
+{
+    const float2 texCoord = GetTexCoord(Position.xy);
+
+    const float depth = tDepth.Sample(sDepth, texCoord);
+    if (depth == 1.0F) discard;
+
+    const float3 normal   = DecodeNormal(tNormal.Sample(sNormal, texCoord).xy);
+    const float  distance = length(cUniform.Origo - GetPosition(Position.xy, depth));
+
+    float2 size;
+    tLightDiffuse.GetDimensions(size.x, size.y);
+
+    /* the lit texels around this pixel, kept to those the light pass covered */
+    const float2 texel   = (floor(Position.xy) + 0.5F) / cUniform.Scale - 0.5F;
+    const float2 base    = floor(texel);
+    const float2 weights = texel - base;
+    const float2 first   = ceil(cUniform.Viewport.xy / cUniform.Scale - 0.5F);
+    const float2 last    = ceil(
+        (cUniform.Viewport.xy + cUniform.Viewport.zw) / cUniform.Scale - 0.5F
+    ) - 1.0F;
+
+    Lighting lighting = { 0.0F.xxx, 0.0F.xxx };
+    Lighting nearest  = lighting;
+    float    total    = 0.0F;
+    float    closest  = 0.0F;
+
+    for (uint i = 0; i != 4; ++i) {
+        const float2 offset = float2(i & 1, i >> 1);
+        const float2 tap    = clamp(base + offset, first, last);
+        const float2 pixel  = tap * cUniform.Scale + 0.5F;
+        const float2 coord  = GetTexCoord(pixel);
+        const float  near   = tDepth.Sample(sDepth, coord);
+
+        if (near == 1.0F) continue;
+
+        const float  gap    = abs(
+            length(cUniform.Origo - GetPosition(pixel, near)) - distance
+        ) / distance;
+        const float  facing = saturate(
+            dot(normal, DecodeNormal(tNormal.Sample(sNormal, coord).xy)));
+        const float2 lerped = lerp(1.0F - weights, weights, offset);
+        const float  weight = lerped.x * lerped.y
+                            * pow(facing, 8.0F)
+                            / (gap + 1e-3F);
+        const Lighting tapped = {
+            tLightDiffuse.Sample(sLightDiffuse, (tap + 0.5F) / size).rgb,
+            tLightSpecular.Sample(sLightSpecular, (tap + 0.5F) / size).rgb
+        };
+
+        lighting.Diffuse  += tapped.Diffuse * weight;
+        lighting.Specular += tapped.Specular * weight;
+        total             += weight;
+
+        if (closest <= 1.0F / (gap + 1e-3F)) {
+            closest = 1.0F / (gap + 1e-3F);
+            nearest = tapped;
         }
     }
 
-    const float3 position = tPosition.Sample(sPosition, TexCoord).xyz;
-    const float3 viewDir  = normalize(cUniform.Origo - position);
+    /* every tap disagreed with this pixel, so fall back to the likeliest one */
+    if (total <= 1e-6F) return Compose(nearest, texCoord);
 
-    for (uint i = 0; i != cUniform.OmnisSize; i += sizeof(OmniLight)) {
-        const OmniLight light    = bOmnis.Load<OmniLight>(i);
-        float3          lightDir = light.Position - position;
-        const float     distance = length(lightDir);
+    lighting.Diffuse  /= total;
+    lighting.Specular /= total;
 
-        if (light.Radius <= distance || distance == 0.0F) continue;
+    return Compose(lighting, texCoord);
+}
+#else /* UPSAMPLE */
+#ifdef VOLUME
+Output main(const nointerpolation uint Light    : TEXCOORD0,
+            const float4               Position : SV_Position)
+{
+    const float2 pixel    = GetPixel(Position.xy);
+    const float2 texCoord = GetTexCoord(pixel);
 
-                    lightDir /= distance;
-        const float NdotL     = dot(normal, lightDir);
+    /* the depth target is cleared to the far plane where nothing was drawn */
+    const float depth = tDepth.Sample(sDepth, texCoord);
+    if (depth == 1.0F) discard;
 
-        if (0.0F <= NdotL) {
-            const float attenuation = distance / light.Radius;
+    const float3 position = GetPosition(pixel, depth);
+    Lighting     lighting = { 0.0F.xxx, 0.0F.xxx };
 
-            output += (albedo * NdotL * light.Color
-                    + specular
-                    * pow(
-                          max(dot(normal, normalize(lightDir + viewDir)), 0.0F),
-                          cUniform.Shine
-                      )
-                    * light.Color)
-                    * (1.0F - attenuation * attenuation);
-        }
-    }
+    AddOmni(
+        lighting,
+        bOmnis.Load<OmniLight>(Light * sizeof(OmniLight)),
+        position,
+        DecodeNormal(tNormal.Sample(sNormal, texCoord).xy),
+        normalize(cUniform.Origo - position)
+    );
+
+    return Compose(lighting, texCoord);
+}
+#else /* VOLUME */
+Output main(const float4 Position : SV_Position)
+{
+    /* the G-buffer spans the window while this pass only covers the viewport */
+    const float2 pixel    = GetPixel(Position.xy);
+    const float2 texCoord = GetTexCoord(pixel);
+
+    const float depth = tDepth.Sample(sDepth, texCoord);
+    if (depth == 1.0F) discard;
 
-    return float4(output, 1.0F);
+    return Compose(
+        GetLighting(pixel, depth, DecodeNormal(tNormal.Sample(sNormal, texCoord).xy)),
+        texCoord
+    );
 }
+#endif /* VOLUME */
+#endif /* UPSAMPLE */
@@ -0,0 +1,54 @@
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+struct Input
+{
+    float4 Rect        : TEXCOORD0;
+    uint   Light       : TEXCOORD1;
+    uint   VertexIndex : SV_VertexID;
+};
+
+struct Output
+{
+    nointerpolation uint   Light          : TEXCOORD0;
+                    float4 VertexPosition : SV_Position;
+};
+
+static const float2 CORNERS[6] = {
+    float2(0.0F, 1.0F),
+    float2(0.0F, 0.0F),
+    float2(1.0F, 1.0F),
+    float2(0.0F, 0.0F),
+    float2(1.0F, 0.0F),
+    float2(1.0F, 1.0F)
+};
+
+Output main(const Input input)
+{
+    Output output;
+
+    output.Light          = input.Light;
+    output.VertexPosition = float4(
+        lerp(input.Rect.xy, input.Rect.zw, CORNERS[input.VertexIndex]), 0.0F, 1.0F
+    );
+
+    return output;
+}
@@ -0,0 +1,273 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "atlas.h"
+
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_surface.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct
+{
+    Uint32 x;
+    Uint32 y;
+    Uint32 width;
+} FG_SkylineNode;
+
+typedef struct
+{
+    FG_SkylineNode *nodes;
+    Uint32          count;
+    Uint32          padding;
+} FG_Skyline;
+
+typedef struct
+{
+    Uint32 index;
+    Uint32 width;
+    Uint32 height;
+} FG_AtlasItem;
+
+static Sint32 SDLCALL FG_AtlasItemComparator(const void *lhs, const void *rhs);
+
+static bool FG_SkylineFit(const FG_Skyline *self,
+                          Uint32            index,
+                          Uint32            width,
+                          Uint32            height,
+                          Uint32            size,
+                          Uint32           *y);
+
+static void FG_SkylineInsert(FG_Skyline *self,
+                             Uint32      index,
+                             Uint32      y,
+                             Uint32      width,
+                             Uint32      height);
+
+static bool FG_SkylineAdd(FG_Skyline *self,
+                          Uint32      width,
+                          Uint32      height,
+                          Uint32      size,
+                          Uint32      padding,
+                          SDL_Rect   *rect);
+
+Sint32 FG_AtlasItemComparator(const void *lhs, const void *rhs)
+{
+    const FG_AtlasItem *lhs_item = lhs;
+    const FG_AtlasItem *rhs_item = rhs;
+
+    if (lhs_item->height != rhs_item->height) {
+        return lhs_item->height < rhs_item->height ? 1 : -1;
+    }
+
+    if (lhs_item->width != rhs_item->width) {
+        return lhs_item->width < rhs_item->width ? 1 : -1;
+    }
+
+    return lhs_item->index < rhs_item->index ? -1 : 1;
+}
+
+bool FG_SkylineFit(const FG_Skyline *self,
+                   Uint32            index,
+                   Uint32            width,
+                   Uint32            height,
+                   Uint32            size,
+                   Uint32           *y)
+{
+    Uint32 remaining = width;
+
+    if (size - self->nodes[index].x < width) return false;
+
+    /* the placement rests on the highest node it spans */
+    *y = self->nodes[index].y;
+    while (true) {
+        *y = SDL_max(*y, self->nodes[index].y);
+        if (size - *y < height) return false;
+
+        if (remaining <= self->nodes[index].width) return true;
+
+        remaining -= self->nodes[index].width;
+        ++index;
+    }
+}
+
+void FG_SkylineInsert(FG_Skyline *self,
+                      Uint32      index,
+                      Uint32      y,
+                      Uint32      width,
+                      Uint32      height)
+{
+    const Uint32 x      = self->nodes[index].x;
+    Uint32       shrink = 0;
+    Uint32       i      = 0;
+
+    SDL_memmove(self->nodes + index + 1,
+                self->nodes + index,
+                (self->count - index) * sizeof(*self->nodes));
+    ++self->count;
+
+    self->nodes[index] = (FG_SkylineNode){ .x = x, .y = y + height, .width = width };
+
+    /* trim the nodes the new one now shadows */
+    for (i = index + 1; i != self->count;) {
+        if (x + width <= self->nodes[i].x) break;
+
+        shrink = x + width - self->nodes[i].x;
+        if (shrink < self->nodes[i].width) {
+            self->nodes[i].x     += shrink;
+            self->nodes[i].width -= shrink;
+            break;
+        }
+
+        SDL_memmove(self->nodes + i,
+                    self->nodes + i + 1,
+                    (self->count - i - 1) * sizeof(*self->nodes));
+        --self->count;
+    }
+
+    for (i = 0; i + 1 < self->count;) {
+        if (self->nodes[i].y == self->nodes[i + 1].y) {
+            self->nodes[i].width += self->nodes[i + 1].width;
+
+            SDL_memmove(self->nodes + i + 1,
+                        self->nodes + i + 2,
+                        (self->count - i - 2) * sizeof(*self->nodes));
+            --self->count;
+        }
+        else ++i;
+    }
+}
+
+bool FG_SkylineAdd(FG_Skyline *self,
+                   Uint32      width,
+                   Uint32      height,
+                   Uint32      size,
+                   Uint32      padding,
+                   SDL_Rect   *rect)
+{
+    Uint32 best   = self->count;
+    Uint32 best_y = 0;
+    Uint32 y      = 0;
+    Uint32 i      = 0;
+
+    /* bottom left: the lowest placement, then the leftmost one */
+    for (i = 0; i != self->count; ++i) {
+        if (FG_SkylineFit(self, i, width, height, size, &y) &&
+            (best == self->count || y < best_y)
+        ) {
+            best   = i;
+            best_y = y;
+        }
+    }
+
+    if (best == self->count) return false;
+
+    rect->x = (Sint32)(self->nodes[best].x + padding);
+    rect->y = (Sint32)(best_y + padding);
+
+    FG_SkylineInsert(self, best, best_y, width, height);
+
+    return true;
+}
+
+bool FG_PackAtlas(const SDL_Surface *const *surfaces,
+                  Uint32                    count,
+                  Uint32                    size,
+                  Uint32                    padding,
+                  SDL_Rect                 *rects,
+                  Uint32                   *layers,
+                  Uint32                   *layer_count)
+{
+    FG_AtlasItem *items    = SDL_malloc(count * sizeof(*items));
+    FG_Skyline   *skylines = SDL_calloc(count, sizeof(*skylines));
+    FG_Skyline   *skyline  = NULL;
+    Uint32        i        = 0;
+    Uint32        j        = 0;
+    bool          result   = true;
+
+    *layer_count = 0;
+
+    if (!items || !skylines) {
+        SDL_free(skylines);
+        SDL_free(items);
+        return false;
+    }
+
+    for (i = 0; i != count; ++i) {
+        items[i] = (FG_AtlasItem){
+            .index  = i,
+            .width  = FG_GetAtlasExtent((Uint32)surfaces[i]->w, padding),
+            .height = FG_GetAtlasExtent((Uint32)surfaces[i]->h, padding)
+        };
+    }
+
+    /* tallest first keeps the skyline flat */
+    SDL_qsort(items, count, sizeof(*items), FG_AtlasItemComparator);
+
+    for (i = 0; i != count; ++i) {
+        rects[items[i].index].w = surfaces[items[i].index]->w;
+        rects[items[i].index].h = surfaces[items[i].index]->h;
+
+        for (j = 0; j != *layer_count; ++j) {
+            if (FG_SkylineAdd(skylines + j,
+                              items[i].width,
+                              items[i].height,
+                              size,
+                              padding,
+                              rects + items[i].index)) {
+                break;
+            }
+        }
+
+        if (j == *layer_count) {
+            skyline        = skylines + j;
+            skyline->nodes = SDL_malloc((count + 1) * sizeof(*skyline->nodes));
+            if (!skyline->nodes) {
+                result = false;
+                break;
+            }
+
+            skyline->nodes[0] = (FG_SkylineNode){ .width = size };
+            skyline->count    = 1;
+            ++*layer_count;
+
+            /* an empty page always takes a sprite that passed the size check */
+            FG_SkylineAdd(skyline,
+                          items[i].width,
+                          items[i].height,
+                          size,
+                          padding,
+                          rects + items[i].index);
+        }
+
+        layers[items[i].index] = j;
+    }
+
+    for (i = 0; i != *layer_count; ++i) SDL_free(skylines[i].nodes);
+    SDL_free(skylines);
+    SDL_free(items);
+
+    return result;
+}
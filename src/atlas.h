@@ -0,0 +1,53 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_ATLAS_H
+#define FLYGPU_ATLAS_H
+
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_surface.h>
+
+#include <stdbool.h>
+
+/* the least gap kept around every sprite so filtering never reaches a neighbor */
+#define FG_ATLAS_PADDING 2
+
+/* every further mip level doubles the padding, so the chain is kept short */
+#define FG_ATLAS_LEVELS 4
+
+/* sprites sit on multiples of the padding, so each mip texel stays in one gap */
+static inline Uint32 FG_GetAtlasExtent(Uint32 extent, Uint32 padding)
+{
+    return (extent + 3 * padding - 1) / padding * padding;
+}
+
+bool FG_PackAtlas(const SDL_Surface *const *surfaces,
+                  Uint32                    count,
+                  Uint32                    size,
+                  Uint32                    padding,
+                  SDL_Rect                 *rects,
+                  Uint32                   *layers,
+                  Uint32                   *layer_count);
+
+#endif /* FLYGPU_ATLAS_H */
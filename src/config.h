@@ -26,9 +26,22 @@
 
 #include <SDL3/SDL_gpu.h>
 
-#define FG_GBUF_COUNT  4
-#define FG_GBUF_FORMAT SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT
+#define FG_GBUF_COUNT         3
+#define FG_GBUF_LAYOUTS       2
+#define FG_GBUF_FORMAT        SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT
+#define FG_GBUF_NORMAL_FORMAT SDL_GPU_TEXTUREFORMAT_R16G16_FLOAT
+#define FG_GBUF_COLOR_FORMAT  SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM
 
-#define FG_DEPTH_FORMAT SDL_GPU_TEXTUREFORMAT_D16_UNORM
+#define FG_DEPTH_FORMAT SDL_GPU_TEXTUREFORMAT_D32_FLOAT
+
+#define FG_LIGHT_FORMAT SDL_GPU_TEXTUREFORMAT_R16G16B16A16_FLOAT
+
+#define FG_FRAMES_IN_FLIGHT 3
+
+#define FG_LIGHT_TILE_SIZE 32
+
+#define FG_DYNRES_MIN_SCALE 0.25F
+#define FG_DYNRES_STEP      0.05F
+#define FG_DYNRES_SMOOTHING 0.1F
 
 #endif /* FLYGPU_CONFIG_H */
@@ -0,0 +1,125 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "dds.h"
+
+#include "../include/flygpu/flygpu.h"
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+static FG_CompressedImage * FG_ReadDDS(SDL_IOStream *src);
+
+FG_CompressedImage * FG_ReadDDS(SDL_IOStream *src)
+{
+    Uint32              words[FG_DDS_WORD_COUNT] = { 0 };
+    Uint32              i                        = 0;
+    FG_Compression      compression              = FG_COMPRESSION_BC7;
+    size_t              size                     = 0;
+    FG_CompressedImage *image                    = NULL;
+
+    for (i = 0; i != FG_DDS_WORD_COUNT; ++i) {
+        if (!SDL_ReadU32LE(src, words + i)) return NULL;
+    }
+
+    if (words[FG_DDS_WORD_MAGIC] != FG_DDS_MAGIC ||
+        words[FG_DDS_WORD_SIZE] != FG_DDS_HEADER_SIZE ||
+        words[FG_DDS_WORD_PF_SIZE] != FG_DDS_FORMAT_SIZE
+    ) {
+        SDL_SetError("FlyGPU: Not a DDS file!");
+        return NULL;
+    }
+
+    if (!(words[FG_DDS_WORD_PF_FLAGS] & FG_DDS_FOURCC) ||
+        words[FG_DDS_WORD_PF_FOURCC] != FG_DDS_DX10 ||
+        words[FG_DDS_WORD_DIMENSION] != FG_DDS_DIMENSION_2D ||
+        words[FG_DDS_WORD_ARRAY] != 1
+    ) {
+        SDL_SetError("FlyGPU: DDS file must hold a single DX10 2D texture!");
+        return NULL;
+    }
+
+    switch (words[FG_DDS_WORD_FORMAT]) {
+    case FG_DXGI_FORMAT_BC3_UNORM:
+        compression = FG_COMPRESSION_BC3;
+        break;
+    case FG_DXGI_FORMAT_BC5_UNORM:
+        compression = FG_COMPRESSION_BC5;
+        break;
+    case FG_DXGI_FORMAT_BC7_UNORM:
+        compression = FG_COMPRESSION_BC7;
+        break;
+    default:
+        SDL_SetError("FlyGPU: DDS format must be BC3, BC5 or BC7!");
+        return NULL;
+    }
+
+    if (!words[FG_DDS_WORD_WIDTH] || !words[FG_DDS_WORD_HEIGHT] ||
+        !words[FG_DDS_WORD_LEVELS] || 32 < words[FG_DDS_WORD_LEVELS]
+    ) {
+        SDL_SetError("FlyGPU: Invalid DDS size!");
+        return NULL;
+    }
+
+    for (i = 0; i != words[FG_DDS_WORD_LEVELS]; ++i) {
+        size += FG_GetCompressedLevelSize(
+            words[FG_DDS_WORD_WIDTH], words[FG_DDS_WORD_HEIGHT], i);
+    }
+
+    image = SDL_malloc(sizeof(*image) + size);
+    if (!image) return NULL;
+
+    image->compression = compression;
+    image->width       = words[FG_DDS_WORD_WIDTH];
+    image->height      = words[FG_DDS_WORD_HEIGHT];
+    image->level_count = words[FG_DDS_WORD_LEVELS];
+    image->levels      = image + 1;
+
+    if (SDL_ReadIO(src, image + 1, size) != size) {
+        SDL_free(image);
+        return NULL;
+    }
+
+    return image;
+}
+
+FG_CompressedImage * FG_LoadDDS_IO(SDL_IOStream *src, bool closeio)
+{
+    FG_CompressedImage *image = NULL;
+
+    if (!src) return NULL;
+
+    image = FG_ReadDDS(src);
+    if (closeio) SDL_CloseIO(src);
+
+    return image;
+}
+
+FG_CompressedImage * FG_LoadDDS(const char *file)
+{
+    return FG_LoadDDS_IO(SDL_IOFromFile(file, "rb"), true);
+}
@@ -0,0 +1,74 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_DDS_H
+#define FLYGPU_DDS_H
+
+#include <SDL3/SDL_stdinc.h>
+
+#define FG_DDS_MAGIC        0x20534444
+#define FG_DDS_HEADER_SIZE  124
+#define FG_DDS_FORMAT_SIZE  32
+#define FG_DDS_DX10         0x30315844
+#define FG_DDS_DIMENSION_2D 3
+#define FG_DDS_FLAGS        0x000A1007
+#define FG_DDS_FOURCC       0x00000004
+#define FG_DDS_CAPS         0x00401008
+
+/* the magic, the header and its DX10 extension as little endian words */
+#define FG_DDS_WORD_COUNT     37
+#define FG_DDS_WORD_MAGIC     0
+#define FG_DDS_WORD_SIZE      1
+#define FG_DDS_WORD_FLAGS     2
+#define FG_DDS_WORD_HEIGHT    3
+#define FG_DDS_WORD_WIDTH     4
+#define FG_DDS_WORD_PITCH     5
+#define FG_DDS_WORD_LEVELS    7
+#define FG_DDS_WORD_PF_SIZE   19
+#define FG_DDS_WORD_PF_FLAGS  20
+#define FG_DDS_WORD_PF_FOURCC 21
+#define FG_DDS_WORD_CAPS      27
+#define FG_DDS_WORD_FORMAT    32
+#define FG_DDS_WORD_DIMENSION 33
+#define FG_DDS_WORD_ARRAY     35
+
+#define FG_DXGI_FORMAT_BC3_UNORM 77
+#define FG_DXGI_FORMAT_BC5_UNORM 83
+#define FG_DXGI_FORMAT_BC7_UNORM 98
+
+#define FG_BLOCK_DIM  4
+#define FG_BLOCK_SIZE 16
+
+static inline Uint32 FG_GetCompressedLevelSize(Uint32 width,
+                                               Uint32 height,
+                                               Uint32 level)
+{
+    const Uint32 columns = (SDL_max(width >> level, 1) + FG_BLOCK_DIM - 1)
+                         / FG_BLOCK_DIM;
+    const Uint32 rows    = (SDL_max(height >> level, 1) + FG_BLOCK_DIM - 1)
+                         / FG_BLOCK_DIM;
+
+    return columns * rows * FG_BLOCK_SIZE;
+}
+
+#endif /* FLYGPU_DDS_H */
@@ -23,12 +23,18 @@
 
 #include "../include/flygpu/flygpu.h"
 
+#include "atlas.h"
 #include "config.h"
+#include "dds.h"
 #include "environment_stage.h"
+#include "jobs.h"
 #include "linalg.h"
 #include "quad3_stage.h"
 #include "shading_stage.h"
+#include "staging.h"
+#include "uploads.h"
 
+#include <SDL3/SDL_bits.h>
 #include <SDL3/SDL_error.h>
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_pixels.h>
@@ -36,6 +42,7 @@
 #include <SDL3/SDL_rect.h>
 #include <SDL3/SDL_stdinc.h>
 #include <SDL3/SDL_surface.h>
+#include <SDL3/SDL_timer.h>
 #include <SDL3/SDL_video.h>
 
 #include <stdbool.h>
@@ -43,25 +50,47 @@
 
 #define FG_SURFACE_FORMAT SDL_PIXELFORMAT_ABGR8888
 
+static const SDL_GPUTextureFormat FG_COMPRESSED_FORMATS[] = {
+    SDL_GPU_TEXTUREFORMAT_BC3_RGBA_UNORM,
+    SDL_GPU_TEXTUREFORMAT_BC5_RG_UNORM,
+    SDL_GPU_TEXTUREFORMAT_BC7_RGBA_UNORM
+};
+
 struct FG_Renderer
 {
     SDL_Window                      *window;
     SDL_GPUDevice                   *device;
-    SDL_GPUTransferBufferCreateInfo  transbuf_info;
+    FG_Staging                      *staging;
+    FG_Uploads                      *uploads;
+    FG_Jobs                         *jobs;
     SDL_GPUTextureCreateInfo         targbuf_info;
-    SDL_GPUTransferBuffer           *transbuf;
-    SDL_GPUFence                    *fence;
+    FG_GBufferLayout                 gbuf_layout;
     SDL_GPUColorTargetInfo           gbuftarg_infos[FG_GBUF_COUNT];
     SDL_GPUDepthStencilTargetInfo    depthtarg_info;
     FG_ShadingStage                 *shading_stage;
     FG_Quad3Stage                   *quad3_stage;
     FG_EnvironmentStage             *environment_stage;
     FG_Material                      material;
+    SDL_GPUTexture                  *scenetex;
+    Uint64                           last_tick;
+    float                            frame_time;
+    float                            target_time;
+    float                            min_scale;
+    float                            max_scale;
+    float                            scale;
+    FG_RenderPath                    path;
 };
 
 static Sint32 SDLCALL FG_CameraComparator(const void *lhs, const void *rhs);
 
-FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
+static void FG_RendererUpdateScale(FG_Renderer *self);
+
+static bool FG_CheckSurface(const SDL_Surface *surface);
+
+FG_Renderer * FG_CreateRenderer(SDL_Window    *window,
+                                FG_RenderPath  path,
+                                bool           vsync,
+                                bool           debug)
 {
     FG_Renderer          *self        = SDL_calloc(1, sizeof(*self));
     SDL_PropertiesID      props       = 0;
@@ -76,6 +105,7 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
     if (!self) return NULL;
 
     self->window = window;
+    self->path   = path;
 
     props = SDL_CreateProperties();
     if (!props) {
@@ -177,25 +207,48 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
     self->targbuf_info.layer_count_or_depth = 1;
     self->targbuf_info.num_levels           = 1;
 
+    self->min_scale = 1.0F;
+    self->max_scale = 1.0F;
+    self->scale     = 1.0F;
+
+    /* only pixels covered by depth are shaded, so colors never need a clear */
     for (i = 0; i != SDL_arraysize(self->gbuftarg_infos); ++i) {
-        self->gbuftarg_infos[i].load_op = SDL_GPU_LOADOP_CLEAR;
+        self->gbuftarg_infos[i].load_op = SDL_GPU_LOADOP_DONT_CARE;
     }
 
     self->depthtarg_info.clear_depth      = 1.0F;
     self->depthtarg_info.load_op          = SDL_GPU_LOADOP_CLEAR;
-    self->depthtarg_info.store_op         = SDL_GPU_STOREOP_DONT_CARE;
+    self->depthtarg_info.store_op         = SDL_GPU_STOREOP_STORE;
     self->depthtarg_info.stencil_load_op  = SDL_GPU_LOADOP_DONT_CARE;
     self->depthtarg_info.stencil_store_op = SDL_GPU_STOREOP_DONT_CARE;
 
     targbuf_fmt = SDL_GetGPUSwapchainTextureFormat(self->device, self->window);
 
+    self->staging = FG_CreateStaging(self->device);
+    if (!self->staging) {
+        FG_DestroyRenderer(self);
+        return NULL;
+    }
+
+    self->uploads = FG_CreateUploads(self->device);
+    if (!self->uploads) {
+        FG_DestroyRenderer(self);
+        return NULL;
+    }
+
+    self->jobs = FG_CreateJobs();
+    if (!self->jobs) {
+        FG_DestroyRenderer(self);
+        return NULL;
+    }
+
     self->shading_stage = FG_CreateShadingStage(self->device, targbuf_fmt);
     if (!self->shading_stage) {
         FG_DestroyRenderer(self);
         return NULL;
     }
 
-    self->quad3_stage = FG_CreateQuad3Stage(self->device);
+    self->quad3_stage = FG_CreateQuad3Stage(self->device, self->path, targbuf_fmt);
     if (!self->quad3_stage) {
         FG_DestroyRenderer(self);
         return NULL;
@@ -209,7 +262,7 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
 
     surface.pixels = &(Uint32){ 0xFFFFFFFF };
 
-    if (!FG_RendererCreateTexture(
+    if (!FG_RendererEnqueueTexture(
         self, &surface, false, &self->material.maps.albedo) ||
         !self->material.maps.albedo
     ) {
@@ -219,7 +272,7 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
 
     surface.pixels = &(Uint32){ 0xFF0A0A0A };
 
-    if (!FG_RendererCreateTexture(
+    if (!FG_RendererEnqueueTexture(
         self, &surface, false, &self->material.maps.specular) ||
         !self->material.maps.specular
     ) {
@@ -229,7 +282,7 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
 
     surface.pixels = &(Uint32){ 0xFFFF8080 };
 
-    if (!FG_RendererCreateTexture(
+    if (!FG_RendererEnqueueTexture(
         self, &surface, false, &self->material.maps.normal) ||
         !self->material.maps.normal
     ) {
@@ -237,6 +290,11 @@ FG_Renderer * FG_CreateRenderer(SDL_Window *window, bool vsync, bool debug)
         return NULL;
     }
 
+    if (!FG_RendererSubmitUploads(self, NULL)) {
+        FG_DestroyRenderer(self);
+        return NULL;
+    }
+
     return self;
 }
 
@@ -245,97 +303,448 @@ bool FG_RendererCreateTexture(FG_Renderer        *self,
                               bool                mipmaps,
                               SDL_GPUTexture    **texture)
 {
-    const SDL_PixelFormatDetails *details  = SDL_GetPixelFormatDetails(
-        surface->format);
+    return FG_RendererCreateTextureArray(self, &surface, 1, mipmaps, texture);
+}
+
+bool FG_RendererCreateTextureArray(FG_Renderer               *self,
+                                   const SDL_Surface *const  *surfaces,
+                                   Uint32                     count,
+                                   bool                       mipmaps,
+                                   SDL_GPUTexture           **texture)
+{
+    if (!FG_RendererEnqueueTextureArray(self, surfaces, count, mipmaps, texture)) {
+        return false;
+    }
+
+    return !*texture || FG_RendererSubmitUploads(self, NULL);
+}
+
+bool FG_RendererCreateCompressedTexture(FG_Renderer               *self,
+                                        const FG_CompressedImage  *image,
+                                        SDL_GPUTexture           **texture)
+{
+    if (!FG_RendererEnqueueCompressedTexture(self, image, texture)) return false;
+
+    return !*texture || FG_RendererSubmitUploads(self, NULL);
+}
+
+bool FG_RendererCreateAtlas(FG_Renderer               *self,
+                            const SDL_Surface *const  *surfaces,
+                            Uint32                     count,
+                            Uint32                     size,
+                            bool                       mipmaps,
+                            SDL_GPUTexture           **texture,
+                            FG_AtlasSprite            *sprites)
+{
+    if (!FG_RendererEnqueueAtlas(
+        self, surfaces, count, size, mipmaps, texture, sprites)) {
+        return false;
+    }
+
+    return !*texture || FG_RendererSubmitUploads(self, NULL);
+}
+
+bool FG_RendererEnqueueTexture(FG_Renderer        *self,
+                               const SDL_Surface  *surface,
+                               bool                mipmaps,
+                               SDL_GPUTexture    **texture)
+{
+    return FG_RendererEnqueueTextureArray(self, &surface, 1, mipmaps, texture);
+}
+
+bool FG_RendererEnqueueTextureArray(FG_Renderer               *self,
+                                    const SDL_Surface *const  *surfaces,
+                                    Uint32                     count,
+                                    bool                       mipmaps,
+                                    SDL_GPUTexture           **texture)
+{
+    const SDL_PixelFormatDetails *details  = NULL;
     Sint32                        size     = 0;
     SDL_GPUTextureCreateInfo      info     = {
+        .type                 = SDL_GPU_TEXTURETYPE_2D_ARRAY,
         .format               = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
         .usage                = SDL_GPU_TEXTUREUSAGE_SAMPLER
                               | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
-        .width                = (Uint32)surface->w,
-        .height               = (Uint32)surface->h,
-        .layer_count_or_depth = 1,
+        .layer_count_or_depth = count,
         .num_levels           = 1
     };
-    void                         *transmem = NULL;
-    SDL_GPUCommandBuffer         *cmdbuf   = NULL;
-    SDL_GPUCopyPass              *cpypass  = NULL;
+    Uint32                        i        = 0;
+    bool                          result   = true;
 
     *texture = NULL;
 
+    if (!count) {
+        SDL_SetError("FlyGPU: Texture array must have at least one layer!");
+        return true;
+    }
+
+    details = SDL_GetPixelFormatDetails(surfaces[0]->format);
     if (!details) return false;
 
-    size = surface->w * surface->h * details->bytes_per_pixel;
+    info.width  = (Uint32)surfaces[0]->w;
+    info.height = (Uint32)surfaces[0]->h;
+
+    size = surfaces[0]->w * surfaces[0]->h * details->bytes_per_pixel;
     if (size <= 0) {
         SDL_SetError("FlyGPU: Invalid surface size!");
         return true;
     }
 
+    for (i = 0; i != count; ++i) {
+        if (surfaces[i]->w != surfaces[0]->w || surfaces[i]->h != surfaces[0]->h) {
+            SDL_SetError("FlyGPU: Texture array layers must have the same size!");
+            return true;
+        }
+
+        if (!FG_CheckSurface(surfaces[i])) return true;
+    }
+
+    if (mipmaps) {
+        info.num_levels += (Uint32)(SDL_logf((float)SDL_max(info.width, info.height)));
+    }
+
+    *texture = SDL_CreateGPUTexture(self->device, &info);
+    if (!*texture) return false;
+
+    /* a texture and its mipmaps always go out in the same batch */
+    FG_UploadsLock(self->uploads);
+
+    for (i = 0; result && i != count; ++i) {
+        result = FG_UploadsToTexture(
+            self->uploads,
+            &(SDL_GPUTextureRegion){
+                .texture = *texture,
+                .layer   = i,
+                .w       = info.width,
+                .h       = info.height,
+                .d       = 1
+            },
+            surfaces[i]->pixels,
+            (Uint32)size
+        );
+    }
+
+    if (result && 1 != info.num_levels) {
+        result = FG_UploadsGenerateMipmaps(self->uploads, *texture);
+    }
+
+    FG_UploadsUnlock(self->uploads);
+
+    return result;
+}
+
+bool FG_RendererEnqueueCompressedTexture(FG_Renderer               *self,
+                                         const FG_CompressedImage  *image,
+                                         SDL_GPUTexture           **texture)
+{
+    SDL_GPUTextureCreateInfo  info   = {
+        .type                 = SDL_GPU_TEXTURETYPE_2D_ARRAY,
+        .usage                = SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width                = image->width,
+        .height               = image->height,
+        .layer_count_or_depth = 1,
+        .num_levels           = image->level_count
+    };
+    Uint32                    levels = 0;
+    const Uint8              *texels = image->levels;
+    Uint32                    size   = 0;
+    Uint32                    i      = 0;
+    bool                      result = true;
+
+    *texture = NULL;
+
+    if (SDL_arraysize(FG_COMPRESSED_FORMATS) <= (Uint32)image->compression) {
+        SDL_SetError("FlyGPU: Invalid texture compression!");
+        return true;
+    }
+
+    /* block compressed levels are only complete in whole 4x4 blocks at the top */
+    if (!info.width || info.width % FG_BLOCK_DIM ||
+        !info.height || info.height % FG_BLOCK_DIM
+    ) {
+        SDL_SetError("FlyGPU: Compressed texture size must be a multiple of 4!");
+        return true;
+    }
+
+    while (SDL_max(info.width, info.height) >> levels) ++levels;
+
+    if (!info.num_levels || levels < info.num_levels) {
+        SDL_SetError("FlyGPU: Invalid compressed texture level count!");
+        return true;
+    }
+
+    info.format = FG_COMPRESSED_FORMATS[image->compression];
+
+    if (!SDL_GPUTextureSupportsFormat(
+        self->device, info.format, info.type, info.usage)) {
+        SDL_SetError("FlyGPU: Texture compression is not supported by this device!");
+        return true;
+    }
+
+    *texture = SDL_CreateGPUTexture(self->device, &info);
+    if (!*texture) return false;
+
+    FG_UploadsLock(self->uploads);
+
+    for (i = 0; result && i != info.num_levels; ++i) {
+        size   = FG_GetCompressedLevelSize(info.width, info.height, i);
+        result = FG_UploadsToTexture(
+            self->uploads,
+            &(SDL_GPUTextureRegion){
+                .texture   = *texture,
+                .mip_level = i,
+                .w         = SDL_max(info.width >> i, 1),
+                .h         = SDL_max(info.height >> i, 1),
+                .d         = 1
+            },
+            texels,
+            size
+        );
+
+        texels += size;
+    }
+
+    FG_UploadsUnlock(self->uploads);
+
+    return result;
+}
+
+bool FG_RendererEnqueueAtlas(FG_Renderer               *self,
+                             const SDL_Surface *const  *surfaces,
+                             Uint32                     count,
+                             Uint32                     size,
+                             bool                       mipmaps,
+                             SDL_GPUTexture           **texture,
+                             FG_AtlasSprite            *sprites)
+{
+    SDL_Rect                 *rects   = NULL;
+    Uint32                   *layers  = NULL;
+    Uint8                    *page    = NULL;
+    Uint32                    pitch   = size * sizeof(Uint32);
+    Uint32                    padding = FG_ATLAS_PADDING;
+    SDL_GPUTextureCreateInfo  info    = {
+        .type       = SDL_GPU_TEXTURETYPE_2D_ARRAY,
+        .format     = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+        .usage      = SDL_GPU_TEXTUREUSAGE_SAMPLER
+                    | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+        .width      = size,
+        .height     = size,
+        .num_levels = 1
+    };
+    Uint32                    i       = 0;
+    Uint32                    j       = 0;
+    Sint32                    row     = 0;
+    bool                      result  = true;
+
+    *texture = NULL;
+
+    if (!count || !size) {
+        SDL_SetError("FlyGPU: Atlas must have at least one sprite and a size!");
+        return true;
+    }
+
+    if (mipmaps) {
+        info.num_levels = 1 + (Uint32)SDL_MostSignificantBitIndex32(size);
+        info.num_levels = SDL_min(info.num_levels, FG_ATLAS_LEVELS);
+        padding         = SDL_max(padding, 1U << (info.num_levels - 1));
+    }
+
+    for (i = 0; i != count; ++i) {
+        if (surfaces[i]->w <= 0 || surfaces[i]->h <= 0) {
+            SDL_SetError("FlyGPU: Invalid surface size!");
+            return true;
+        }
+
+        if (size < FG_GetAtlasExtent(
+            (Uint32)SDL_max(surfaces[i]->w, surfaces[i]->h), padding)) {
+            SDL_SetError("FlyGPU: Sprite %u does not fit in the atlas!", i);
+            return true;
+        }
+
+        if (!FG_CheckSurface(surfaces[i])) return true;
+    }
+
+    rects  = SDL_malloc(count * sizeof(*rects));
+    layers = SDL_malloc(count * sizeof(*layers));
+    if (!rects || !layers) {
+        SDL_free(layers);
+        SDL_free(rects);
+        return false;
+    }
+
+    if (!FG_PackAtlas(
+        surfaces, count, size, padding, rects, layers, &info.layer_count_or_depth)) {
+        SDL_free(layers);
+        SDL_free(rects);
+        return false;
+    }
+
+    page     = SDL_malloc((size_t)pitch * size);
+    *texture = page ? SDL_CreateGPUTexture(self->device, &info) : NULL;
+    result   = NULL != *texture;
+
+    if (*texture) FG_UploadsLock(self->uploads);
+
+    /* every page is one layer, so the whole atlas binds as a single material */
+    for (i = 0; result && i != info.layer_count_or_depth; ++i) {
+        SDL_memset(page, 0, (size_t)pitch * size);
+
+        for (j = 0; j != count; ++j) {
+            if (layers[j] != i) continue;
+
+            for (row = 0; row != rects[j].h; ++row) {
+                SDL_memcpy(
+                    page + (Uint32)(rects[j].y + row) * pitch
+                         + (Uint32)rects[j].x * sizeof(Uint32),
+                    (const Uint8 *)surfaces[j]->pixels + row * surfaces[j]->pitch,
+                    (size_t)rects[j].w * sizeof(Uint32)
+                );
+            }
+        }
+
+        result = FG_UploadsToTexture(
+            self->uploads,
+            &(SDL_GPUTextureRegion){
+                .texture = *texture,
+                .layer   = i,
+                .w       = size,
+                .h       = size,
+                .d       = 1
+            },
+            page,
+            pitch * size
+        );
+    }
+
+    for (i = 0; i != count; ++i) {
+        sprites[i] = (FG_AtlasSprite){
+            .coords = {
+                .tl = {
+                    .x = (float)rects[i].x / (float)size,
+                    .y = (float)rects[i].y / (float)size
+                },
+                .br = {
+                    .x = (float)(rects[i].x + rects[i].w) / (float)size,
+                    .y = (float)(rects[i].y + rects[i].h) / (float)size
+                }
+            },
+            .layer  = layers[i]
+        };
+    }
+
+    if (result && 1 != info.num_levels) {
+        result = FG_UploadsGenerateMipmaps(self->uploads, *texture);
+    }
+
+    if (*texture) FG_UploadsUnlock(self->uploads);
+
+    SDL_free(page);
+    SDL_free(layers);
+    SDL_free(rects);
+
+    return result;
+}
+
+bool FG_CheckSurface(const SDL_Surface *surface)
+{
     if (surface->format != FG_SURFACE_FORMAT) {
         SDL_SetError(
             "FlyGPU: Surface format must be %s!",
             SDL_GetPixelFormatName(FG_SURFACE_FORMAT)
         );
-        return true;
+        return false;
     }
 
     if (SDL_MUSTLOCK(surface) &&
         (surface->flags & SDL_SURFACE_LOCKED) != SDL_SURFACE_LOCKED
     ) {
         SDL_SetError("FlyGPU: This surface must be locked!");
-        return true;
+        return false;
     }
 
-    if (mipmaps) {
-        info.num_levels += (Uint32)(SDL_logf((float)SDL_max(info.width, info.height)));
-    }
+    return true;
+}
 
-    *texture = SDL_CreateGPUTexture(self->device, &info);
-    if (!texture) return false;
+bool FG_RendererSubmitUploads(FG_Renderer *self, Uint64 *token)
+{
+    return FG_UploadsSubmit(self->uploads, token);
+}
+
+bool FG_RendererQueryUploads(FG_Renderer *self, Uint64 token)
+{
+    return FG_UploadsQuery(self->uploads, token);
+}
 
-    if (self->transbuf_info.size < (Uint32)size) {
-        self->transbuf_info.size = (Uint32)size;
+bool FG_RendererCreateQuad3(FG_Renderer *self, const FG_Quad3 *quad3, Uint32 *handle)
+{
+    return FG_Quad3StageCreateQuad3(self->quad3_stage, quad3, handle);
+}
 
-        SDL_ReleaseGPUTransferBuffer(self->device, self->transbuf);
-        self->transbuf = SDL_CreateGPUTransferBuffer(
-            self->device, &self->transbuf_info);
-        if (!self->transbuf) return false;
-    }
+void FG_RendererUpdateQuad3(FG_Renderer *self, Uint32 handle, const FG_Quad3 *quad3)
+{
+    FG_Quad3StageUpdateQuad3(self->quad3_stage, handle, quad3);
+}
+
+void FG_RendererDestroyQuad3(FG_Renderer *self, Uint32 handle)
+{
+    FG_Quad3StageDestroyQuad3(self->quad3_stage, handle);
+}
 
-    transmem = SDL_MapGPUTransferBuffer(self->device, self->transbuf, true);
-    if (!transmem) return false;
+void FG_RendererSetLighting(FG_Renderer *self, FG_Lighting lighting)
+{
+    /* forward shaded quads only read the tiled light lists */
+    if (self->path == FG_RENDERPATH_FORWARD) return;
 
-    SDL_memcpy(transmem, surface->pixels, (size_t)size);
+    FG_ShadingStageSetLighting(self->shading_stage, lighting);
+}
 
-    SDL_UnmapGPUTransferBuffer(self->device, self->transbuf);
+void FG_RendererSetGBufferLayout(FG_Renderer *self, FG_GBufferLayout layout)
+{
+    if (self->gbuf_layout == layout || self->path == FG_RENDERPATH_FORWARD) return;
 
-    cmdbuf = SDL_AcquireGPUCommandBuffer(self->device);
-    if (!cmdbuf) return false;
+    self->gbuf_layout = layout;
+    FG_Quad3StageSetGBufferLayout(self->quad3_stage, layout);
 
-    cpypass = SDL_BeginGPUCopyPass(cmdbuf);
-    SDL_UploadToGPUTexture(
-        cpypass,
-        &(SDL_GPUTextureTransferInfo){ .transfer_buffer = self->transbuf },
-        &(SDL_GPUTextureRegion){
-            .texture = *texture,
-            .w       = info.width,
-            .h       = info.height,
-            .d       = 1
-        },
-        false
-    );
-    SDL_EndGPUCopyPass(cpypass);
+    /* the G-buffer is recreated in the new formats on the next draw */
+    self->targbuf_info.width = 0;
+}
 
-    if (1 < info.num_levels) SDL_GenerateMipmapsForGPUTexture(cmdbuf, *texture);
+void FG_RendererSetDynamicResolution(FG_Renderer *self,
+                                     float        target_time,
+                                     float        min_scale,
+                                     float        max_scale)
+{
+    self->target_time = target_time;
+    self->frame_time  = target_time;
+    self->min_scale   = SDL_clamp(min_scale, FG_DYNRES_MIN_SCALE, 1.0F);
+    self->max_scale   = SDL_clamp(max_scale, self->min_scale, 1.0F);
+    self->scale       = 0.0F < target_time ? self->max_scale : 1.0F;
+
+    /* the scene target is created or released on the next draw */
+    self->targbuf_info.width = 0;
+}
+
+void FG_RendererUpdateScale(FG_Renderer *self)
+{
+    Uint64 tick  = SDL_GetTicksNS();
+    float  scale = 0.0F;
 
-    if (self->fence) {
-        if (!SDL_WaitForGPUFences(self->device, true, &self->fence, 1)) return false;
-        SDL_ReleaseGPUFence(self->device, self->fence);
-        self->fence = NULL;
+    if (self->last_tick) {
+        self->frame_time += ((float)(tick - self->last_tick) / SDL_NS_PER_MS
+                           - self->frame_time) * FG_DYNRES_SMOOTHING;
     }
+    self->last_tick = tick;
 
-    self->fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
-    return self->fence;
+    if (self->target_time <= 0.0F) return;
+
+    /* the cost of a frame follows its pixel count, so the square of the scale */
+    scale = self->scale * SDL_sqrtf(self->target_time / self->frame_time);
+
+    /* a bound is always taken, however small the step to it */
+    if (scale <= self->min_scale || self->max_scale <= scale ||
+        FG_DYNRES_STEP <= SDL_fabsf(scale - self->scale)) {
+        self->scale = SDL_clamp(scale, self->min_scale, self->max_scale);
+    }
 }
 
 Sint32 FG_CameraComparator(const void *lhs, const void *rhs)
@@ -347,6 +756,8 @@ bool FG_RendererDraw(FG_Renderer *self, const FG_RendererDrawInfo *info)
 {
     Uint32                  i                           = 0;
     const FG_Camera        *cameras[info->camera_count];
+    SDL_GPUViewport         viewports[info->camera_count];
+    FG_Mat4                 vpmats[info->camera_count];
     SDL_GPUCommandBuffer   *cmdbuf                      = SDL_AcquireGPUCommandBuffer(
         self->device);
     SDL_GPUColorTargetInfo  swapctarg_info              = {
@@ -359,28 +770,34 @@ bool FG_RendererDraw(FG_Renderer *self, const FG_RendererDrawInfo *info)
     };
     Uint32                  width                       = 0;
     Uint32                  height                      = 0;
+    SDL_GPUTexture         *swapctex                    = NULL;
+    Uint32                  render_width                = 0;
+    Uint32                  render_height               = 0;
     SDL_GPURenderPass      *rndrpass                    = NULL;
     SDL_GPUViewport         viewport                    = { .max_depth = 1.0F };
     FG_Mat4                 projmat                     = { 0 };
     FG_Mat4                 viewmat                     = { 0 };
-    FG_Mat4                 vpmat                       = { 0 };
     SDL_GPUCopyPass        *cpypass                     = NULL;
+    FG_RendererStats        stats                       = { 0 };
+    bool                    deferred                    = false;
 
     for (i = 0; i != SDL_arraysize(cameras); ++i) cameras[i] = info->cameras + i;
 
     if (!cmdbuf) return false;
 
     if (!SDL_AcquireGPUSwapchainTexture(
-        cmdbuf, self->window, &swapctarg_info.texture, &width, &height)) {
+        cmdbuf, self->window, &swapctex, &width, &height)) {
         return false;
     }
 
-    if (!swapctarg_info.texture) return SDL_CancelGPUCommandBuffer(cmdbuf);
+    if (!swapctex) return SDL_CancelGPUCommandBuffer(cmdbuf);
 
-    swapctarg_info.load_op = SDL_GPU_LOADOP_CLEAR;
+    /* enqueued textures land before drawing, unless a worker is still staging */
+    if (!FG_UploadsTrySubmit(self->uploads)) return false;
 
-    rndrpass = SDL_BeginGPURenderPass(cmdbuf, &swapctarg_info, 1, NULL);
-    SDL_EndGPURenderPass(rndrpass);
+    if (!FG_StagingBegin(self->staging)) return false;
+
+    FG_RendererUpdateScale(self);
 
     SDL_qsort(cameras, SDL_arraysize(cameras), sizeof(*cameras), FG_CameraComparator);
 
@@ -388,103 +805,209 @@ bool FG_RendererDraw(FG_Renderer *self, const FG_RendererDrawInfo *info)
         self->targbuf_info.width  = width;
         self->targbuf_info.height = height;
 
-        self->targbuf_info.format = FG_GBUF_FORMAT;
-        self->targbuf_info.usage  = SDL_GPU_TEXTUREUSAGE_SAMPLER
-                                  | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
-
-        for (i = 0; i != SDL_arraysize(self->gbuftarg_infos); ++i) {
-            SDL_ReleaseGPUTexture(self->device, self->gbuftarg_infos[i].texture);
-            self->gbuftarg_infos[i].texture = SDL_CreateGPUTexture(
-                self->device, &self->targbuf_info);
-            if (!self->gbuftarg_infos[i].texture) return false;
-        }
-
         self->targbuf_info.format = FG_DEPTH_FORMAT;
-        self->targbuf_info.usage  = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
+        self->targbuf_info.usage  = SDL_GPU_TEXTUREUSAGE_SAMPLER
+                                  | SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET;
 
         SDL_ReleaseGPUTexture(self->device, self->depthtarg_info.texture);
         self->depthtarg_info.texture = SDL_CreateGPUTexture(
             self->device, &self->targbuf_info);
         if (!self->depthtarg_info.texture) return false;
 
-        FG_ShadingStageUpdate(self->shading_stage, self->gbuftarg_infos);
+        /* forward rendering never allocates a G-buffer */
+        if (self->path == FG_RENDERPATH_DEFERRED) {
+            self->targbuf_info.usage = SDL_GPU_TEXTUREUSAGE_SAMPLER
+                                     | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+
+            for (i = 0; i != SDL_arraysize(self->gbuftarg_infos); ++i) {
+                self->targbuf_info.format = FG_GetGBufFormat(
+                    self->gbuf_layout, (Uint8)i);
+
+                SDL_ReleaseGPUTexture(self->device, self->gbuftarg_infos[i].texture);
+                self->gbuftarg_infos[i].texture = SDL_CreateGPUTexture(
+                    self->device, &self->targbuf_info);
+                if (!self->gbuftarg_infos[i].texture) return false;
+            }
+
+            if (!FG_ShadingStageUpdate(self->shading_stage,
+                                       width,
+                                       height,
+                                       self->gbuftarg_infos,
+                                       self->depthtarg_info.texture)) {
+                return false;
+            }
+        }
+
+        /* scaled frames are rendered into the top left of a window sized target */
+        SDL_ReleaseGPUTexture(self->device, self->scenetex);
+        self->scenetex = NULL;
+
+        if (0.0F < self->target_time) {
+            self->targbuf_info.format = SDL_GetGPUSwapchainTextureFormat(
+                self->device, self->window);
+            self->targbuf_info.usage  = SDL_GPU_TEXTUREUSAGE_SAMPLER
+                                      | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET;
+
+            self->scenetex = SDL_CreateGPUTexture(self->device, &self->targbuf_info);
+            if (!self->scenetex) return false;
+        }
     }
 
+    render_width  = SDL_max((Uint32)((float)width * self->scale), 1);
+    render_height = SDL_max((Uint32)((float)height * self->scale), 1);
+
+    swapctarg_info.texture = self->scenetex ? self->scenetex : swapctex;
+    swapctarg_info.load_op = SDL_GPU_LOADOP_CLEAR;
+
+    rndrpass = SDL_BeginGPURenderPass(cmdbuf, &swapctarg_info, 1, NULL);
+    SDL_EndGPURenderPass(rndrpass);
+
     swapctarg_info.load_op = SDL_GPU_LOADOP_LOAD;
 
     for (i = 0; i != SDL_arraysize(cameras); ++i) {
-        viewport.x = cameras[i]->viewport.tl.x * (float)width;
-        viewport.y = cameras[i]->viewport.tl.y * (float)height;
-        viewport.w = (cameras[i]->viewport.br.x - cameras[i]->viewport.tl.x)
-                   * (float)width;
-        viewport.h = (cameras[i]->viewport.br.y - cameras[i]->viewport.tl.y)
-                   * (float)height;
-
-        FG_SetProjMat4(&cameras[i]->perspective, viewport.w / viewport.h, &projmat);
+        viewports[i]   = viewport;
+        viewports[i].x = cameras[i]->viewport.tl.x * (float)render_width;
+        viewports[i].y = cameras[i]->viewport.tl.y * (float)render_height;
+        viewports[i].w = (cameras[i]->viewport.br.x - cameras[i]->viewport.tl.x)
+                       * (float)render_width;
+        viewports[i].h = (cameras[i]->viewport.br.y - cameras[i]->viewport.tl.y)
+                       * (float)render_height;
+
+        FG_SetProjMat4(
+            &cameras[i]->perspective, viewports[i].w / viewports[i].h, &projmat);
         FG_SetViewMat4(&cameras[i]->transf, &viewmat);
-        FG_MulMat4s(&projmat, &viewmat, &vpmat);
+        FG_MulMat4s(&projmat, &viewmat, vpmats + i);
+    }
 
-        cpypass = SDL_BeginGPUCopyPass(cmdbuf);
-        if (!FG_Quad3StageCopy(
-            self->quad3_stage, cpypass, cameras[i]->mask, &vpmat, &info->quad3_info)) {
-            return false;
-        }
-        if (!FG_ShadingStageCopy(
-            self->shading_stage,
-            cpypass,
-            cameras[i]->mask,
-            &info->shading_info
-        )) {
-            return false;
-        }
-        SDL_EndGPUCopyPass(cpypass);
+    if (!FG_Quad3StageCopy(
+        self->quad3_stage,
+        self->staging,
+        self->jobs,
+        info->camera_count,
+        cameras,
+        vpmats,
+        &info->quad3_info,
+        &stats
+    )) {
+        return false;
+    }
+    if (!FG_ShadingStageCopy(
+        self->shading_stage,
+        self->staging,
+        self->jobs,
+        info->camera_count,
+        cameras,
+        viewports,
+        vpmats,
+        &info->shading_info
+    )) {
+        return false;
+    }
 
-        rndrpass = SDL_BeginGPURenderPass(
-            cmdbuf,
-            self->gbuftarg_infos,
-            SDL_arraysize(self->gbuftarg_infos),
-            &self->depthtarg_info
-        );
-        SDL_SetGPUViewport(rndrpass, &viewport);
-        FG_Quad3StageDraw(self->quad3_stage, rndrpass, &self->material);
-        SDL_EndGPURenderPass(rndrpass);
+    cpypass = SDL_BeginGPUCopyPass(cmdbuf);
+    FG_StagingFlush(self->staging, cpypass);
+    SDL_EndGPUCopyPass(cpypass);
+
+    for (i = 0; i != SDL_arraysize(cameras); ++i) {
+        /* later cameras reset depth within their own viewport only */
+        self->depthtarg_info.load_op = i ? SDL_GPU_LOADOP_LOAD : SDL_GPU_LOADOP_CLEAR;
+
+        deferred = self->path == FG_RENDERPATH_DEFERRED && !cameras[i]->unlit;
+
+        if (deferred) {
+            rndrpass = SDL_BeginGPURenderPass(
+                cmdbuf,
+                self->gbuftarg_infos,
+                SDL_arraysize(self->gbuftarg_infos),
+                &self->depthtarg_info
+            );
+            SDL_SetGPUViewport(rndrpass, viewports + i);
+            if (i) FG_Quad3StageClear(self->quad3_stage, rndrpass, cameras[i]);
+            FG_Quad3StageDraw(
+                self->quad3_stage, cmdbuf, rndrpass, i, vpmats + i, &self->material);
+            SDL_EndGPURenderPass(rndrpass);
+
+            FG_ShadingStageDrawLights(
+                self->shading_stage, cmdbuf, i, viewports + i, vpmats + i, cameras[i]);
+        }
 
         rndrpass = SDL_BeginGPURenderPass(cmdbuf, &swapctarg_info, 1, NULL);
-        SDL_SetGPUViewport(rndrpass, &viewport);
+        SDL_SetGPUViewport(rndrpass, viewports + i);
         FG_EnvironmentStageDraw(
             self->environment_stage,
             cmdbuf,
             rndrpass,
-            viewport.w,
-            viewport.h,
+            viewports[i].w,
+            viewports[i].h,
             cameras[i],
             self->material.maps.albedo
         );
-        viewport.x = 0.0F;
-        viewport.y = 0.0F;
-        viewport.w = (float)width;
-        viewport.h = (float)height;
-        SDL_SetGPUViewport(rndrpass, &viewport);
-        SDL_SetGPUScissor(
-            rndrpass,
-            &(SDL_Rect){
-                .x = (Sint32)viewport.x,
-                .y = (Sint32)viewport.y,
-                .w = (Sint32)viewport.w,
-                .h = (Sint32)viewport.h
-            }
-        );
-        FG_ShadingStageDraw(self->shading_stage, cmdbuf, rndrpass, cameras[i]);
+        if (deferred) {
+            SDL_SetGPUScissor(
+                rndrpass,
+                &(SDL_Rect){
+                    .x = (Sint32)viewports[i].x,
+                    .y = (Sint32)viewports[i].y,
+                    .w = (Sint32)SDL_ceilf(viewports[i].w),
+                    .h = (Sint32)SDL_ceilf(viewports[i].h)
+                }
+            );
+            FG_ShadingStageDraw(self->shading_stage,
+                                cmdbuf,
+                                rndrpass,
+                                i,
+                                viewports + i,
+                                vpmats + i,
+                                cameras[i]);
+        }
         SDL_EndGPURenderPass(rndrpass);
+
+        if (!deferred) {
+            /* quads are shaded as they are drawn, straight over the environment */
+            rndrpass = SDL_BeginGPURenderPass(
+                cmdbuf, &swapctarg_info, 1, &self->depthtarg_info);
+            SDL_SetGPUViewport(rndrpass, viewports + i);
+            if (i) FG_Quad3StageClear(self->quad3_stage, rndrpass, cameras[i]);
+            if (cameras[i]->unlit ||
+                FG_ShadingStageBindLights(self->shading_stage,
+                                          cmdbuf,
+                                          rndrpass,
+                                          i,
+                                          viewports + i,
+                                          vpmats + i,
+                                          cameras[i])
+            ) {
+                FG_Quad3StageDraw(self->quad3_stage,
+                                  cmdbuf,
+                                  rndrpass,
+                                  i,
+                                  vpmats + i,
+                                  &self->material);
+            }
+            SDL_EndGPURenderPass(rndrpass);
+        }
     }
 
-    if (self->fence) {
-        if (!SDL_WaitForGPUFences(self->device, true, &self->fence, 1)) return false;
-        SDL_ReleaseGPUFence(self->device, self->fence);
-        self->fence = NULL;
+    if (self->scenetex) {
+        SDL_BlitGPUTexture(
+            cmdbuf,
+            &(SDL_GPUBlitInfo){
+                .source      = {
+                    .texture = self->scenetex,
+                    .w       = render_width,
+                    .h       = render_height
+                },
+                .destination = { .texture = swapctex, .w = width, .h = height },
+                .load_op     = SDL_GPU_LOADOP_DONT_CARE,
+                .filter      = SDL_GPU_FILTER_LINEAR
+            }
+        );
     }
 
-    return SDL_SubmitGPUCommandBuffer(cmdbuf);
+    stats.resolution_scale = self->scale;
+    if (info->stats) *info->stats = stats;
+
+    return FG_StagingSubmit(self->staging, cmdbuf);
 }
 
 void FG_RendererDestroyTexture(FG_Renderer *self, SDL_GPUTexture *texture)
@@ -503,12 +1026,14 @@ void FG_DestroyRenderer(FG_Renderer *self)
     FG_DestroyEnvironmentStage(self->environment_stage);
     FG_DestroyQuad3Stage(self->quad3_stage);
     FG_DestroyShadingStage(self->shading_stage);
+    SDL_ReleaseGPUTexture(self->device, self->scenetex);
     SDL_ReleaseGPUTexture(self->device, self->depthtarg_info.texture);
     for (i = 0; i != SDL_arraysize(self->gbuftarg_infos); ++i) {
         SDL_ReleaseGPUTexture(self->device, self->gbuftarg_infos[i].texture);
     }
-    SDL_ReleaseGPUFence(self->device, self->fence);
-    SDL_ReleaseGPUTransferBuffer(self->device, self->transbuf);
+    FG_DestroyJobs(self->jobs);
+    FG_DestroyUploads(self->uploads);
+    FG_DestroyStaging(self->staging);
     SDL_ReleaseWindowFromGPUDevice(self->device, self->window);
     SDL_DestroyGPUDevice(self->device);
     SDL_free(self);
@@ -0,0 +1,260 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "jobs.h"
+
+#include <SDL3/SDL_atomic.h>
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_thread.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct
+{
+    FG_Jobs      *jobs;
+    SDL_Thread   *thread;
+    SDL_SpinLock  lock;
+    Uint32        begin;
+    Uint32        end;
+    Uint32        padding[9];
+} FG_JobQueue;
+
+struct FG_Jobs
+{
+    SDL_Mutex      *mutex;
+    SDL_Condition  *condition;
+    FG_JobQueue    *queues;
+    FG_JobFunction  func;
+    void           *data;
+    SDL_AtomicInt   remaining;
+    SDL_AtomicInt   busy;
+    Uint32          queue_count;
+    Uint32          generation;
+    Uint32          count;
+    Uint32          grain;
+    bool            quit;
+    Uint8           padding[7];
+};
+
+static Sint32 SDLCALL FG_JobsWorker(void *data);
+
+static void FG_JobsRun(FG_Jobs *self, FG_JobQueue *queue);
+
+static bool FG_JobsPop(FG_JobQueue *queue, Uint32 *chunk);
+
+static bool FG_JobsSteal(FG_Jobs *self, FG_JobQueue *queue, Uint32 *chunk);
+
+FG_Jobs * FG_CreateJobs(void)
+{
+    FG_Jobs *self = SDL_calloc(1, sizeof(*self));
+    Uint32   i    = 0;
+
+    if (!self) return NULL;
+
+    self->queue_count = (Uint32)SDL_max(SDL_GetNumLogicalCPUCores(), 1);
+
+    self->queues = SDL_calloc(self->queue_count, sizeof(*self->queues));
+    if (!self->queues) {
+        FG_DestroyJobs(self);
+        return NULL;
+    }
+
+    self->mutex = SDL_CreateMutex();
+    if (!self->mutex) {
+        FG_DestroyJobs(self);
+        return NULL;
+    }
+
+    self->condition = SDL_CreateCondition();
+    if (!self->condition) {
+        FG_DestroyJobs(self);
+        return NULL;
+    }
+
+    /* the first queue belongs to the thread calling FG_JobsParallelFor */
+    for (i = 0; i != self->queue_count; ++i) self->queues[i].jobs = self;
+
+    for (i = 1; i != self->queue_count; ++i) {
+        self->queues[i].thread = SDL_CreateThread(
+            FG_JobsWorker, "FlyGPU Worker", self->queues + i);
+        if (!self->queues[i].thread) {
+            FG_DestroyJobs(self);
+            return NULL;
+        }
+    }
+
+    return self;
+}
+
+Sint32 FG_JobsWorker(void *data)
+{
+    FG_JobQueue *queue      = data;
+    FG_Jobs     *self       = queue->jobs;
+    Uint32       generation = 0;
+
+    for (;;) {
+        SDL_LockMutex(self->mutex);
+        while (!self->quit && self->generation == generation) {
+            SDL_WaitCondition(self->condition, self->mutex);
+        }
+        generation = self->generation;
+        if (self->quit) {
+            SDL_UnlockMutex(self->mutex);
+            return 0;
+        }
+        SDL_AddAtomicInt(&self->busy, 1);
+        SDL_UnlockMutex(self->mutex);
+
+        FG_JobsRun(self, queue);
+        SDL_AddAtomicInt(&self->busy, -1);
+    }
+}
+
+void FG_JobsRun(FG_Jobs *self, FG_JobQueue *queue)
+{
+    Uint32 chunk = 0;
+    Uint32 begin = 0;
+
+    while (FG_JobsPop(queue, &chunk) || FG_JobsSteal(self, queue, &chunk)) {
+        begin = chunk * self->grain;
+
+        self->func(
+            self->data, chunk, begin, SDL_min(begin + self->grain, self->count));
+        SDL_AddAtomicInt(&self->remaining, -1);
+    }
+}
+
+bool FG_JobsPop(FG_JobQueue *queue, Uint32 *chunk)
+{
+    bool popped = false;
+
+    SDL_LockSpinlock(&queue->lock);
+    if (queue->begin != queue->end) {
+        *chunk = queue->begin++;
+        popped = true;
+    }
+    SDL_UnlockSpinlock(&queue->lock);
+
+    return popped;
+}
+
+bool FG_JobsSteal(FG_Jobs *self, FG_JobQueue *queue, Uint32 *chunk)
+{
+    Uint32       i      = 0;
+    FG_JobQueue *victim = NULL;
+    Uint32       begin  = 0;
+    Uint32       end    = 0;
+
+    /* take the back half of the first non-empty queue after our own */
+    for (i = 1; i != self->queue_count; ++i) {
+        victim = self->queues
+               + ((Uint32)(queue - self->queues) + i) % self->queue_count;
+
+        SDL_LockSpinlock(&victim->lock);
+        end         = victim->end;
+        begin       = end - (end - victim->begin + 1) / 2;
+        victim->end = begin;
+        SDL_UnlockSpinlock(&victim->lock);
+
+        if (begin == end) continue;
+
+        SDL_LockSpinlock(&queue->lock);
+        queue->begin = begin + 1;
+        queue->end   = end;
+        SDL_UnlockSpinlock(&queue->lock);
+
+        *chunk = begin;
+        return true;
+    }
+
+    return false;
+}
+
+Uint32 FG_GetJobChunkCount(Uint32 count, Uint32 grain)
+{
+    return (count + grain - 1) / grain;
+}
+
+void FG_JobsParallelFor(FG_Jobs        *self,
+                        Uint32          count,
+                        Uint32          grain,
+                        FG_JobFunction  func,
+                        void           *data)
+{
+    Uint32 chunk_count = FG_GetJobChunkCount(count, grain);
+    Uint32 i           = 0;
+
+    if (chunk_count < 2 || self->queue_count < 2) {
+        for (i = 0; i != chunk_count; ++i) {
+            func(data, i, i * grain, SDL_min((i + 1) * grain, count));
+        }
+        return;
+    }
+
+    /* workers still searching the previous job's queues would race the refill */
+    SDL_LockMutex(self->mutex);
+    while (SDL_GetAtomicInt(&self->busy)) SDL_CPUPauseInstruction();
+
+    self->func  = func;
+    self->data  = data;
+    self->count = count;
+    self->grain = grain;
+    SDL_SetAtomicInt(&self->remaining, (int)chunk_count);
+
+    for (i = 0; i != self->queue_count; ++i) {
+        self->queues[i].begin = (Uint32)((Uint64)chunk_count * i / self->queue_count);
+        self->queues[i].end   = (Uint32)(
+            (Uint64)chunk_count * (i + 1) / self->queue_count);
+    }
+
+    ++self->generation;
+    SDL_BroadcastCondition(self->condition);
+    SDL_UnlockMutex(self->mutex);
+
+    FG_JobsRun(self, self->queues);
+
+    while (SDL_GetAtomicInt(&self->remaining)) SDL_CPUPauseInstruction();
+}
+
+void FG_DestroyJobs(FG_Jobs *self)
+{
+    Uint32 i = 0;
+
+    if (!self) return;
+    if (self->mutex) {
+        SDL_LockMutex(self->mutex);
+        self->quit = true;
+        SDL_BroadcastCondition(self->condition);
+        SDL_UnlockMutex(self->mutex);
+    }
+    for (i = 1; i < self->queue_count && self->queues; ++i) {
+        if (self->queues[i].thread) SDL_WaitThread(self->queues[i].thread, NULL);
+    }
+    SDL_DestroyCondition(self->condition);
+    SDL_DestroyMutex(self->mutex);
+    SDL_free(self->queues);
+    SDL_free(self);
+}
@@ -0,0 +1,48 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_JOBS_H
+#define FLYGPU_JOBS_H
+
+#include <SDL3/SDL_stdinc.h>
+
+typedef struct FG_Jobs FG_Jobs;
+
+typedef void (SDLCALL *FG_JobFunction)(void   *data,
+                                       Uint32  chunk,
+                                       Uint32  begin,
+                                       Uint32  end);
+
+FG_Jobs * FG_CreateJobs(void);
+
+Uint32 FG_GetJobChunkCount(Uint32 count, Uint32 grain);
+
+void FG_JobsParallelFor(FG_Jobs        *self,
+                        Uint32          count,
+                        Uint32          grain,
+                        FG_JobFunction  func,
+                        void           *data);
+
+void FG_DestroyJobs(FG_Jobs *self);
+
+#endif /* FLYGPU_JOBS_H */
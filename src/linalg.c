@@ -24,8 +24,18 @@
 #include "../include/flygpu/flygpu.h"
 #include "linalg.h"
 
+#include <SDL3/SDL_intrin.h>
 #include <SDL3/SDL_stdinc.h>
 
+#include <float.h>
+#include <stdbool.h>
+
+#if defined(SDL_AVX_INTRINSICS) && defined(__F16C__)
+#define FG_F16C
+#elif defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+#define FG_NEON_FP16
+#endif /* SDL_AVX_INTRINSICS && __F16C__ */
+
 void FG_SetProjMat4(const FG_Perspective *perspective, float aspect, FG_Mat4 *projmat)
 {
     float focal = 1.0F / SDL_tanf(perspective->fov * 0.5F);
@@ -81,40 +91,140 @@ void FG_MulMat4s(const FG_Mat4 *restrict lhs,
     }
 }
 
-void FG_SetModelMat4(const FG_Transform3 *restrict transf, FG_Mat4 *restrict modelmat)
+bool FG_InvertMat4(const FG_Mat4 *restrict mat, FG_Mat4 *restrict out)
 {
-    float cos = SDL_cosf(transf->rotation);
-    float sin = SDL_sinf(transf->rotation);
+    const float *m    = mat->m;
+    float        s[6] = {
+        m[0] * m[5] - m[4] * m[1],
+        m[0] * m[6] - m[4] * m[2],
+        m[0] * m[7] - m[4] * m[3],
+        m[1] * m[6] - m[5] * m[2],
+        m[1] * m[7] - m[5] * m[3],
+        m[2] * m[7] - m[6] * m[3]
+    };
+    float        c[6] = {
+        m[8] * m[13] - m[12] * m[9],
+        m[8] * m[14] - m[12] * m[10],
+        m[8] * m[15] - m[12] * m[11],
+        m[9] * m[14] - m[13] * m[10],
+        m[9] * m[15] - m[13] * m[11],
+        m[10] * m[15] - m[14] * m[11]
+    };
+    float        det  = s[0] * c[5] - s[1] * c[4] + s[2] * c[3]
+                      + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+    Uint8        i    = 0;
+
+    if (det == 0.0F) return false;
 
-    *modelmat = (FG_Mat4){
+    /* the adjugate from 2x2 minors of the upper and lower halves */
+    *out = (FG_Mat4){
         .m = {
-            [0]  = cos * transf->scale.x,
-            [1]  = sin * transf->scale.x,
-            [4]  = -sin * transf->scale.y,
-            [5]  = cos * transf->scale.y,
-            [10] = 1.0F,
-            [12] = transf->transl.x,
-            [13] = transf->transl.y,
-            [14] = transf->transl.z,
-            [15] = 1.0F
+            m[5] * c[5] - m[6] * c[4] + m[7] * c[3],
+            -m[1] * c[5] + m[2] * c[4] - m[3] * c[3],
+            m[13] * s[5] - m[14] * s[4] + m[15] * s[3],
+            -m[9] * s[5] + m[10] * s[4] - m[11] * s[3],
+            -m[4] * c[5] + m[6] * c[2] - m[7] * c[1],
+            m[0] * c[5] - m[2] * c[2] + m[3] * c[1],
+            -m[12] * s[5] + m[14] * s[2] - m[15] * s[1],
+            m[8] * s[5] - m[10] * s[2] + m[11] * s[1],
+            m[4] * c[4] - m[5] * c[2] + m[7] * c[0],
+            -m[0] * c[4] + m[1] * c[2] - m[3] * c[0],
+            m[12] * s[4] - m[13] * s[2] + m[15] * s[0],
+            -m[8] * s[4] + m[9] * s[2] - m[11] * s[0],
+            -m[4] * c[3] + m[5] * c[1] - m[6] * c[0],
+            m[0] * c[3] - m[1] * c[1] + m[2] * c[0],
+            -m[12] * s[3] + m[13] * s[1] - m[14] * s[0],
+            m[8] * s[3] - m[9] * s[1] + m[10] * s[0]
         }
     };
+
+    det = 1.0F / det;
+    for (i = 0; i != SDL_arraysize(out->m); ++i) out->m[i] *= det;
+
+    return true;
 }
 
-void FG_SetTBNMat3(float rotation, FG_Mat3 *tbnmat)
+#if !defined(FG_F16C) && !defined(FG_NEON_FP16)
+static Uint16 FG_GetHalf(float value);
+#endif /* !FG_F16C && !FG_NEON_FP16 */
+
+static void FG_SetHalf4s(const FG_QuadColor *color, Uint16 (*halves)[4]);
+
+#if !defined(FG_F16C) && !defined(FG_NEON_FP16)
+Uint16 FG_GetHalf(float value)
 {
-    float cos = SDL_cosf(rotation);
-    float sin = SDL_sinf(rotation);
+    Uint32 bits = 0;
+    Uint32 sign = 0;
+    Sint32 exp  = 0;
 
-    *tbnmat = (FG_Mat3){
-        .m = {
-            [0] = cos,
-            [1] = sin,
-            [3] = -sin,
-            [4] = cos,
-            [8] = 1.0F
-        }
-    };
+    SDL_memcpy(&bits, &value, sizeof(bits));
+
+    sign = (bits >> 16) & 0x8000;
+    exp  = (Sint32)((bits >> 23) & 0xFF) - 127 + 15;
+
+    if (exp <= 0) return (Uint16)sign;
+    if (30 < exp) return (Uint16)(sign | 0x7C00);
+
+    return (Uint16)(
+        (sign | (Uint32)exp << 10 | (bits & 0x7FFFFF) >> 13) + ((bits >> 12) & 1));
+}
+#endif /* !FG_F16C && !FG_NEON_FP16 */
+
+void FG_SetHalf4s(const FG_QuadColor *restrict color, Uint16 (*restrict halves)[4])
+{
+#if defined(FG_F16C)
+    const __m128i  lo        = _mm256_cvtps_ph(
+        _mm256_setr_ps(
+            color->tl.x, color->tl.y, color->tl.z, 1.0F,
+            color->bl.x, color->bl.y, color->bl.z, 1.0F
+        ),
+        _MM_FROUND_TO_NEAREST_INT
+    );
+    const __m128i  hi        = _mm256_cvtps_ph(
+        _mm256_setr_ps(
+            color->br.x, color->br.y, color->br.z, 1.0F,
+            color->tr.x, color->tr.y, color->tr.z, 1.0F
+        ),
+        _MM_FROUND_TO_NEAREST_INT
+    );
+
+    SDL_memcpy(halves[0], &lo, sizeof(lo));
+    SDL_memcpy(halves[2], &hi, sizeof(hi));
+#else
+    const FG_Vec3 *colors[4] = { &color->tl, &color->bl, &color->br, &color->tr };
+    Uint8          i         = 0;
+
+    for (i = 0; i != SDL_arraysize(colors); ++i) {
+#if defined(FG_NEON_FP16)
+        vst1_u16(
+            halves[i],
+            vreinterpret_u16_f16(vcvt_f16_f32(
+                (float32x4_t){ colors[i]->x, colors[i]->y, colors[i]->z, 1.0F }))
+        );
+#else
+        halves[i][0] = FG_GetHalf(colors[i]->x);
+        halves[i][1] = FG_GetHalf(colors[i]->y);
+        halves[i][2] = FG_GetHalf(colors[i]->z);
+        halves[i][3] = 0x3C00;
+#endif /* FG_NEON_FP16 */
+    }
+#endif /* FG_F16C */
+}
+
+void FG_SetQuad3Ins(const FG_Quad3 *restrict quad3s,
+                    Uint32                   count,
+                    FG_Quad3In     *restrict quad3ins)
+{
+    Uint32 i = 0;
+
+    for (i = 0; i != count; ++i) {
+        quad3ins[i].transl   = quad3s[i].transf.transl;
+        quad3ins[i].rotation = quad3s[i].transf.rotation;
+        quad3ins[i].scale    = quad3s[i].transf.scale;
+        FG_SetHalf4s(&quad3s[i].color, quad3ins[i].colors);
+        quad3ins[i].coords   = quad3s[i].coords;
+        quad3ins[i].layer    = quad3s[i].layer;
+    }
 }
 
 float FG_hypot1f(float y)
@@ -138,3 +248,179 @@ void FG_SetEnvMat4(const FG_Vec2 *scale, float rotation, FG_Mat4 *envmat)
         }
     };
 }
+
+void FG_SetFrustum(const FG_Mat4 *restrict vpmat, FG_Frustum *restrict frustum)
+{
+    Uint8  i      = 0;
+    Uint8  j      = 0;
+    float *plane  = NULL;
+    float  length = 0.0F;
+
+    for (i = 0; i != 6; ++i) {
+        plane = frustum->planes + i * 4;
+        for (j = 0; j != 4; ++j) {
+            plane[j] = i % 2 ? vpmat->m[j * 4 + 3] - vpmat->m[j * 4 + i / 2]
+                             : vpmat->m[j * 4 + 3] + vpmat->m[j * 4 + i / 2];
+        }
+        length = SDL_sqrtf(
+            plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        for (j = 0; j != 4; ++j) plane[j] /= length;
+    }
+}
+
+bool FG_IntersectsFrustum(const FG_Frustum *frustum,
+                          const FG_Vec3    *center,
+                          float             radius)
+{
+    const float *plane = frustum->planes;
+
+    for (; plane != frustum->planes + SDL_arraysize(frustum->planes); plane += 4) {
+        if (plane[0] * center->x + plane[1] * center->y + plane[2] * center->z
+            + plane[3] < -radius) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+Uint8 FG_CullOmniLights4(const FG_OmniLight *restrict omnis,
+                         const FG_Frustum   *restrict frustum,
+                         Uint32                       mask)
+{
+#if defined(SDL_SSE2_INTRINSICS)
+    __m128       x       = _mm_loadu_ps(&omnis[0].transl.x);
+    __m128       y       = _mm_loadu_ps(&omnis[1].transl.x);
+    __m128       z       = _mm_loadu_ps(&omnis[2].transl.x);
+    __m128       radius  = _mm_loadu_ps(&omnis[3].transl.x);
+    __m128       visible = _mm_setzero_ps();
+    __m128i      masks   = _mm_setr_epi32((Sint32)omnis[0].mask,
+                                          (Sint32)omnis[1].mask,
+                                          (Sint32)omnis[2].mask,
+                                          (Sint32)omnis[3].mask);
+    const float *plane   = frustum->planes;
+
+    /* the translation and radius lead each light, so a transpose gives SoA */
+    _MM_TRANSPOSE4_PS(x, y, z, radius);
+
+    masks   = _mm_cmpeq_epi32(
+        _mm_and_si128(masks, _mm_set1_epi32((Sint32)mask)), _mm_setzero_si128());
+    visible = _mm_andnot_ps(
+        _mm_castsi128_ps(masks), _mm_cmpgt_ps(radius, _mm_setzero_ps()));
+    radius  = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+    for (; plane != frustum->planes + SDL_arraysize(frustum->planes); plane += 4) {
+        visible = _mm_and_ps(
+            visible,
+            _mm_cmpge_ps(
+                _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), x),
+                               _mm_mul_ps(_mm_set1_ps(plane[1]), y)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), z),
+                               _mm_set1_ps(plane[3]))
+                ),
+                radius
+            )
+        );
+    }
+
+    return (Uint8)_mm_movemask_ps(visible);
+#elif defined(SDL_NEON_INTRINSICS) && defined(__aarch64__)
+    /* trn1 pairs up x and z of two lights, trn2 y and radius */
+    const float32x4_t  xz01    = vtrn1q_f32(vld1q_f32(&omnis[0].transl.x),
+                                            vld1q_f32(&omnis[1].transl.x));
+    const float32x4_t  yr01    = vtrn2q_f32(vld1q_f32(&omnis[0].transl.x),
+                                            vld1q_f32(&omnis[1].transl.x));
+    const float32x4_t  xz23    = vtrn1q_f32(vld1q_f32(&omnis[2].transl.x),
+                                            vld1q_f32(&omnis[3].transl.x));
+    const float32x4_t  yr23    = vtrn2q_f32(vld1q_f32(&omnis[2].transl.x),
+                                            vld1q_f32(&omnis[3].transl.x));
+    const float32x4_t  x       = vreinterpretq_f32_f64(
+        vzip1q_f64(vreinterpretq_f64_f32(xz01), vreinterpretq_f64_f32(xz23)));
+    const float32x4_t  y       = vreinterpretq_f32_f64(
+        vzip1q_f64(vreinterpretq_f64_f32(yr01), vreinterpretq_f64_f32(yr23)));
+    const float32x4_t  z       = vreinterpretq_f32_f64(
+        vzip2q_f64(vreinterpretq_f64_f32(xz01), vreinterpretq_f64_f32(xz23)));
+    const float32x4_t  radius  = vreinterpretq_f32_f64(
+        vzip2q_f64(vreinterpretq_f64_f32(yr01), vreinterpretq_f64_f32(yr23)));
+    const Uint32       masks[] = {
+        omnis[0].mask, omnis[1].mask, omnis[2].mask, omnis[3].mask
+    };
+    const Uint32       bits[]  = { 1, 2, 4, 8 };
+    uint32x4_t         visible = vandq_u32(
+        vtstq_u32(vld1q_u32(masks), vdupq_n_u32(mask)),
+        vcgtq_f32(radius, vdupq_n_f32(0.0F)));
+    const float       *plane   = frustum->planes;
+
+    for (; plane != frustum->planes + SDL_arraysize(frustum->planes); plane += 4) {
+        visible = vandq_u32(
+            visible,
+            vcgeq_f32(
+                vfmaq_n_f32(
+                    vfmaq_n_f32(vfmaq_n_f32(vdupq_n_f32(plane[3]), x, plane[0]),
+                                y,
+                                plane[1]),
+                    z,
+                    plane[2]
+                ),
+                vnegq_f32(radius)
+            )
+        );
+    }
+
+    return (Uint8)vaddvq_u32(vandq_u32(visible, vld1q_u32(bits)));
+#else
+    Uint8 visible = 0;
+    Uint8 i       = 0;
+
+    for (i = 0; i != 4; ++i) {
+        if (omnis[i].mask & mask && 0.0F < omnis[i].radius &&
+            FG_IntersectsFrustum(frustum, &omnis[i].transl, omnis[i].radius)) {
+            visible |= (Uint8)(1 << i);
+        }
+    }
+
+    return visible;
+#endif /* SDL_SSE2_INTRINSICS */
+}
+
+bool FG_ProjectSphere(const FG_Mat4 *restrict vpmat,
+                      const FG_Vec3 *restrict center,
+                      float                   radius,
+                      FG_AABB       *restrict bounds)
+{
+    Uint8   i      = 0;
+    FG_Vec3 corner = { 0 };
+    float   w      = 0.0F;
+    FG_Vec2 ndc    = { 0 };
+    FG_Vec2 min    = { .x = FLT_MAX, .y = FLT_MAX };
+    FG_Vec2 max    = { .x = -FLT_MAX, .y = -FLT_MAX };
+
+    /* the projected box of the sphere's bounding cube, in viewport units */
+    for (i = 0; i != 8; ++i) {
+        corner.x = center->x + (i & 1 ? radius : -radius);
+        corner.y = center->y + (i & 2 ? radius : -radius);
+        corner.z = center->z + (i & 4 ? radius : -radius);
+
+        w = vpmat->m[3] * corner.x + vpmat->m[7] * corner.y
+          + vpmat->m[11] * corner.z + vpmat->m[15];
+        if (w <= 0.0F) return false;
+
+        ndc.x = (vpmat->m[0] * corner.x + vpmat->m[4] * corner.y
+               + vpmat->m[8] * corner.z + vpmat->m[12]) / w;
+        ndc.y = (vpmat->m[1] * corner.x + vpmat->m[5] * corner.y
+               + vpmat->m[9] * corner.z + vpmat->m[13]) / w;
+
+        min.x = SDL_min(min.x, ndc.x);
+        min.y = SDL_min(min.y, ndc.y);
+        max.x = SDL_max(max.x, ndc.x);
+        max.y = SDL_max(max.y, ndc.y);
+    }
+
+    bounds->tl.x = 0.5F + 0.5F * min.x;
+    bounds->tl.y = 0.5F - 0.5F * max.y;
+    bounds->br.x = 0.5F + 0.5F * max.x;
+    bounds->br.y = 0.5F - 0.5F * min.y;
+
+    return true;
+}
@@ -26,17 +26,31 @@
 
 #include "../include/flygpu/flygpu.h"
 
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+
 #define FG_SQRT2F 1.41421353816986083984375F
 
 typedef struct
 {
-    float m[3 * 3];
-} FG_Mat3;
+    float m[4 * 4];
+} FG_Mat4;
 
 typedef struct
 {
-    float m[4 * 4];
-} FG_Mat4;
+    float planes[6 * 4];
+} FG_Frustum;
+
+typedef struct
+{
+    FG_Vec3 transl;
+    float   rotation;
+    FG_Vec2 scale;
+    Uint16  colors[4][4];
+    FG_AABB coords;
+    Uint32  layer;
+} FG_Quad3In;
 
 void FG_SetProjMat4(const FG_Perspective *perspective, float aspect, FG_Mat4 *projmat);
 
@@ -44,12 +58,27 @@ void FG_SetViewMat4(const FG_Transform3 *transf, FG_Mat4 *viewmat);
 
 void FG_MulMat4s(const FG_Mat4 *lhs, const FG_Mat4 *rhs, FG_Mat4 *out);
 
-void FG_SetModelMat4(const FG_Transform3 *transf, FG_Mat4 *modelmat);
+bool FG_InvertMat4(const FG_Mat4 *mat, FG_Mat4 *out);
 
-void FG_SetTBNMat3(float rotation, FG_Mat3 *tbnmat);
+void FG_SetQuad3Ins(const FG_Quad3 *quad3s, Uint32 count, FG_Quad3In *quad3ins);
 
 float FG_hypot1f(float y);
 
 void FG_SetEnvMat4(const FG_Vec2 *scale, float rotation, FG_Mat4 *envmat);
 
+void FG_SetFrustum(const FG_Mat4 *vpmat, FG_Frustum *frustum);
+
+bool FG_IntersectsFrustum(const FG_Frustum *frustum,
+                          const FG_Vec3    *center,
+                          float             radius);
+
+Uint8 FG_CullOmniLights4(const FG_OmniLight *omnis,
+                         const FG_Frustum   *frustum,
+                         Uint32              mask);
+
+bool FG_ProjectSphere(const FG_Mat4 *vpmat,
+                      const FG_Vec3 *center,
+                      float          radius,
+                      FG_AABB       *bounds);
+
 #endif /* FLYGPU_LINALG_H */
@@ -0,0 +1,267 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif /* _WIN32 */
+
+#include "pack.h"
+
+#include "../include/flygpu/flygpu.h"
+#include "dds.h"
+
+#include <SDL3/SDL_endian.h>
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_platform_defines.h> /* IWYU pragma: keep */
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef SDL_PLATFORM_WINDOWS
+#include <windows.h>
+#else /* SDL_PLATFORM_WINDOWS */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* SDL_PLATFORM_WINDOWS */
+
+struct FG_Pack
+{
+    Uint8              *data;
+    size_t              size;
+    const FG_PackEntry *entries;
+    Uint32              count;
+    Uint32              padding;
+};
+
+static bool FG_MapPack(FG_Pack *self, const char *file);
+
+static void FG_UnmapPack(FG_Pack *self);
+
+static bool FG_ValidatePackEntry(const FG_Pack *self, const FG_PackEntry *entry);
+
+#ifdef SDL_PLATFORM_WINDOWS
+bool FG_MapPack(FG_Pack *self, const char *file)
+{
+    /* paths are UTF-8, which the ANSI code page of CreateFileA can mangle */
+    WCHAR         *path    = (WCHAR *)SDL_iconv_string(
+        "UTF-16LE", "UTF-8", file, SDL_strlen(file) + 1);
+    HANDLE         handle  = INVALID_HANDLE_VALUE;
+    LARGE_INTEGER  size    = { 0 };
+    HANDLE         mapping = NULL;
+
+    if (!path) {
+        SDL_SetError("FlyGPU: Failed to convert the path %s!", file);
+        return false;
+    }
+
+    handle = CreateFileW(path,
+                         GENERIC_READ,
+                         FILE_SHARE_READ,
+                         NULL,
+                         OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL,
+                         NULL);
+    SDL_free(path);
+    if (INVALID_HANDLE_VALUE == handle) {
+        SDL_SetError("FlyGPU: Failed to open %s!", file);
+        return false;
+    }
+
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0) {
+        CloseHandle(handle);
+        SDL_SetError("FlyGPU: Failed to read the size of %s!", file);
+        return false;
+    }
+
+    /* the view keeps the file mapped after both handles are closed */
+    mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(handle);
+    if (!mapping) {
+        SDL_SetError("FlyGPU: Failed to map %s!", file);
+        return false;
+    }
+
+    self->data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!self->data) {
+        SDL_SetError("FlyGPU: Failed to map %s!", file);
+        return false;
+    }
+
+    self->size = (size_t)size.QuadPart;
+
+    return true;
+}
+
+void FG_UnmapPack(FG_Pack *self)
+{
+    if (self->data) UnmapViewOfFile(self->data);
+}
+#else /* SDL_PLATFORM_WINDOWS */
+bool FG_MapPack(FG_Pack *self, const char *file)
+{
+    Sint32       descriptor = open(file, O_RDONLY);
+    struct stat  info;
+    void        *data       = NULL;
+
+    if (descriptor < 0) {
+        SDL_SetError("FlyGPU: Failed to open %s!", file);
+        return false;
+    }
+
+    if (fstat(descriptor, &info) || info.st_size <= 0) {
+        close(descriptor);
+        SDL_SetError("FlyGPU: Failed to read the size of %s!", file);
+        return false;
+    }
+
+    /* the mapping outlives the descriptor */
+    data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (MAP_FAILED == data) {
+        SDL_SetError("FlyGPU: Failed to map %s!", file);
+        return false;
+    }
+
+    self->data = data;
+    self->size = (size_t)info.st_size;
+
+    return true;
+}
+
+void FG_UnmapPack(FG_Pack *self)
+{
+    if (self->data) munmap(self->data, self->size);
+}
+#endif /* SDL_PLATFORM_WINDOWS */
+
+bool FG_ValidatePackEntry(const FG_Pack *self, const FG_PackEntry *entry)
+{
+    const Uint32 width       = SDL_Swap32LE(entry->width);
+    const Uint32 height      = SDL_Swap32LE(entry->height);
+    const Uint32 level_count = SDL_Swap32LE(entry->level_count);
+    const Uint64 offset      = SDL_Swap64LE(entry->offset);
+    const Uint64 size        = SDL_Swap64LE(entry->size);
+    Uint64       expected    = 0;
+    Uint32       i           = 0;
+
+    if (entry->name[FG_PACK_NAME_SIZE - 1] ||
+        (Uint32)FG_COMPRESSION_BC7 < SDL_Swap32LE(entry->compression) ||
+        !level_count || 32 < level_count
+    ) {
+        return false;
+    }
+
+    for (i = 0; i != level_count; ++i) {
+        expected += FG_GetCompressedLevelSize(width, height, i);
+    }
+
+    return size == expected && offset <= self->size && size <= self->size - offset;
+}
+
+FG_Pack * FG_OpenPack(const char *file)
+{
+    FG_Pack             *self   = SDL_calloc(1, sizeof(*self));
+    const FG_PackHeader *header = NULL;
+    Uint32               i      = 0;
+
+    if (!self) return NULL;
+
+    if (!FG_MapPack(self, file)) {
+        FG_ClosePack(self);
+        return NULL;
+    }
+
+    header = (const FG_PackHeader *)self->data;
+
+    if (self->size < sizeof(*header) ||
+        SDL_Swap32LE(header->magic) != FG_PACK_MAGIC ||
+        SDL_Swap32LE(header->version) != FG_PACK_VERSION
+    ) {
+        SDL_SetError("FlyGPU: %s is not an asset pack!", file);
+        FG_ClosePack(self);
+        return NULL;
+    }
+
+    self->count   = SDL_Swap32LE(header->count);
+    self->entries = (const FG_PackEntry *)(header + 1);
+
+    if ((self->size - sizeof(*header)) / sizeof(*self->entries) < self->count) {
+        SDL_SetError("FlyGPU: Asset pack %s is truncated!", file);
+        FG_ClosePack(self);
+        return NULL;
+    }
+
+    /* checked once here so lookups can hand out texels without bounds checks */
+    for (i = 0; i != self->count; ++i) {
+        if (!FG_ValidatePackEntry(self, self->entries + i)) {
+            SDL_SetError("FlyGPU: Asset pack %s has an invalid entry!", file);
+            FG_ClosePack(self);
+            return NULL;
+        }
+    }
+
+    return self;
+}
+
+bool FG_PackGetImage(const FG_Pack      *self,
+                     const char         *name,
+                     FG_CompressedImage *image)
+{
+    Uint32              first = 0;
+    Uint32              last  = self->count;
+    Uint32              half  = 0;
+    const FG_PackEntry *entry = NULL;
+    Sint32              order = 0;
+
+    while (first != last) {
+        half  = first + (last - first) / 2;
+        entry = self->entries + half;
+        order = SDL_strncmp(name, entry->name, FG_PACK_NAME_SIZE);
+
+        if (!order) {
+            image->compression = (FG_Compression)SDL_Swap32LE(entry->compression);
+            image->width       = SDL_Swap32LE(entry->width);
+            image->height      = SDL_Swap32LE(entry->height);
+            image->level_count = SDL_Swap32LE(entry->level_count);
+            image->levels      = self->data + SDL_Swap64LE(entry->offset);
+            return true;
+        }
+
+        if (order < 0) last = half;
+        else first = half + 1;
+    }
+
+    SDL_SetError("FlyGPU: Asset pack has no image named %s!", name);
+    return false;
+}
+
+void FG_ClosePack(FG_Pack *self)
+{
+    if (!self) return;
+    FG_UnmapPack(self);
+    SDL_free(self);
+}
@@ -0,0 +1,54 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_PACK_H
+#define FLYGPU_PACK_H
+
+#include <SDL3/SDL_stdinc.h>
+
+#define FG_PACK_MAGIC     0x4B504746
+#define FG_PACK_VERSION   1
+#define FG_PACK_NAME_SIZE 64
+#define FG_PACK_ALIGNMENT 16
+
+/* little endian on disk, entries sorted by name and texels after the entries */
+typedef struct
+{
+    Uint32 magic;
+    Uint32 version;
+    Uint32 count;
+    Uint32 padding;
+} FG_PackHeader;
+
+typedef struct
+{
+    char   name[FG_PACK_NAME_SIZE];
+    Uint32 compression;
+    Uint32 width;
+    Uint32 height;
+    Uint32 level_count;
+    Uint64 offset;
+    Uint64 size;
+} FG_PackEntry;
+
+#endif /* FLYGPU_PACK_H */
@@ -25,8 +25,11 @@
 
 #include "../include/flygpu/flygpu.h"
 #include "config.h"
+#include "jobs.h"
 #include "linalg.h"
 #include "shader.h"
+#include "shading_stage.h"
+#include "staging.h"
 
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_stdinc.h>
@@ -34,52 +37,150 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-typedef struct FG_Quad3Batch FG_Quad3Batch;
+#define FG_QUAD3_PIPELINES 2
+#define FG_QUAD3_GRAIN     4096
 
-struct FG_Quad3Batch
+/* handles keep the slot in the low bits and its generation in the high bits */
+#define FG_QUAD3_SLOT_BITS 24
+#define FG_QUAD3_SLOT_MASK ((1U << FG_QUAD3_SLOT_BITS) - 1)
+
+typedef struct
 {
-    const FG_Material *material;
-    Uint32             capacity;
-    Uint32             offset;
-    Uint32             count;
-    Uint32             padding;
-    FG_Quad3Batch     *next;
-};
+    FG_Material material;
+    Uint32      id;
+    Uint32      stamp;
+} FG_MaterialSlot;
+
+typedef struct
+{
+    SDL_GPUGraphicsPipeline *pipeline;
+    const FG_Material       *material;
+    Uint32                   offset;
+    Uint32                   count;
+} FG_Quad3Draw;
+
+typedef struct
+{
+    FG_Quad3Stage               *stage;
+    const FG_Quad3StageDrawInfo *info;
+    const FG_Camera             *camera;
+    const FG_Mat4               *vpmat;
+    FG_Frustum                   frustum;
+} FG_Quad3CullJob;
+
+typedef struct
+{
+    const FG_Quad3 *quad3s;
+    const Uint32   *slots;
+    FG_Quad3In     *quad3ins;
+} FG_Quad3PackJob;
 
 struct FG_Quad3Stage
 {
     SDL_GPUDevice                 *device;
     SDL_GPUShader                 *vertshdr;
-    SDL_GPUShader                 *fragshdr;
+    SDL_GPUShader                 *fragshdrs[FG_QUAD3_PIPELINES];
+    SDL_GPUShader                 *unlit_fragshdrs[FG_QUAD3_PIPELINES];
+    SDL_GPUShader                 *clear_vertshdr;
+    SDL_GPUShader                 *clear_fragshdr;
     Uint32                         capacity;
+    SDL_GPUBufferCreateInfo        ssbo_info;
+    Uint32                         index_capacity;
     SDL_GPUBufferCreateInfo        vertbuf_info;
-    const FG_Quad3               **quad3s;
-    FG_Quad3Batch                 *batches_begin;
-    const FG_Quad3Batch           *batches_end;
-    FG_Quad3Batch                 *batches_head;
+    Uint32                         camera_capacity;
+    Uint32                         draw_capacity;
+    Uint32                         pool_capacity;
+    Uint32                         pool_count;
+    Uint32                         free_count;
+    Uint32                         dirty_count;
+    Uint32                         slot_capacity;
+    Uint32                         stamp;
+    FG_Quad3                      *pool;
+    Uint32                        *free_slots;
+    Uint32                        *dirties;
+    bool                          *dirty_flags;
+    bool                          *free_flags;
+    Uint8                         *generations;
+    Uint32                        *material_ids;
+    FG_MaterialSlot               *material_slots;
+    FG_Material                   *materials;
+    Uint64                        *keys;
+    Uint64                        *sorted_keys;
+    Uint32                        *values;
+    Uint32                        *sorted_values;
+    Uint32                        *chunk_counts;
+    Uint32                        *chunk_culls;
+    Uint32                        *indices;
+    FG_Quad3Draw                  *draws;
+    Uint32                        *draw_offsets;
+    SDL_GPUBuffer                 *ssbo;
     SDL_GPUBufferBinding           vertbuf_bind;
-    SDL_GPUTransferBuffer         *transbuf;
     SDL_GPUTextureSamplerBinding   sampler_binds[
         SDL_arraysize(((FG_Material *)0)->iter)
     ];
-    SDL_GPUGraphicsPipeline       *pipeline;
+    FG_GBufferLayout               layout;
+    FG_RenderPath                  path;
+    SDL_GPUGraphicsPipeline       *pipelines[FG_GBUF_LAYOUTS][FG_QUAD3_PIPELINES];
+    SDL_GPUGraphicsPipeline       *clear_pipelines[FG_GBUF_LAYOUTS];
+    SDL_GPUGraphicsPipeline       *unlit_pipelines[FG_QUAD3_PIPELINES];
+    SDL_GPUGraphicsPipeline       *unlit_clear_pipeline;
 };
 
-typedef struct
+static const char *FG_QUAD3_FRAGSHDRS[][FG_QUAD3_PIPELINES] = {
+    { "quad3_opaque.frag", "quad3.frag" },
+    { "quad3_forward_opaque.frag", "quad3_forward.frag" }
+};
+
+static const char *FG_QUAD3_UNLIT_FRAGSHDRS[FG_QUAD3_PIPELINES] = {
+    "quad3_unlit_opaque.frag",
+    "quad3_unlit.frag"
+};
+
+static Uint32 FG_GetMaterialID(FG_Quad3Stage     *self,
+                               const FG_Material *material,
+                               Uint32            *material_count);
+
+static void FG_SortQuad3Keys(FG_Quad3Stage *self, Uint32 count);
+
+static void SDLCALL FG_CullQuad3s(void   *data,
+                                  Uint32  chunk,
+                                  Uint32  begin,
+                                  Uint32  end);
+
+static void SDLCALL FG_PackQuad3s(void   *data,
+                                  Uint32  chunk,
+                                  Uint32  begin,
+                                  Uint32  end);
+
+static void SDLCALL FG_PackImmediateQuad3s(void   *data,
+                                           Uint32  chunk,
+                                           Uint32  begin,
+                                           Uint32  end);
+
+static Sint32 SDLCALL FG_SlotComparator(const void *lhs, const void *rhs);
+
+static const FG_Quad3 * FG_GetQuad3(const FG_Quad3Stage         *self,
+                                    const FG_Quad3StageDrawInfo *info,
+                                    Uint32                       index);
+
+static bool FG_FindQuad3Slot(const FG_Quad3Stage *self, Uint32 handle, Uint32 *slot);
+
+SDL_GPUTextureFormat FG_GetGBufFormat(FG_GBufferLayout layout, Uint8 index)
 {
-    FG_Mat4      modelmat;
-    FG_Mat4      mvpmat;
-    FG_Mat3      tbnmat;
-    FG_QuadColor color;
-    FG_AABB      coords;
-} FG_Quad3In;
+    /* octahedral normals in the first target, colors in the rest */
+    if (layout == FG_GBUFFER_FULL) return FG_GBUF_FORMAT;
 
-static FG_Quad3Batch * FG_GetQuad3Batch(FG_Quad3Stage     *self,
-                                        const FG_Material *material);
+    return index ? FG_GBUF_COLOR_FORMAT : FG_GBUF_NORMAL_FORMAT;
+}
 
-FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device)
+FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice        *device,
+                                    FG_RenderPath         path,
+                                    SDL_GPUTextureFormat  targbuf_fmt)
 {
     Uint8                              i                            = 0;
+    Uint8                              j                            = 0;
+    Uint8                              layout_count                 = FG_GBUF_LAYOUTS;
+    Uint32                             targbuf_count                = FG_GBUF_COUNT;
     SDL_GPUColorTargetDescription      targbuf_descs[FG_GBUF_COUNT] = { 0 };
     FG_Quad3Stage                     *self                         = SDL_calloc(
         1, sizeof(*self));
@@ -88,97 +189,18 @@ FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device)
         .mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
         .max_lod     = 1000.0F
     };
-    SDL_GPUVertexAttribute             vertattrs[]                  = {
-        {
-            .location = 0,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, modelmat.m[0])
-        },
-        {
-            .location = 1,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, modelmat.m[4])
-        },
-        {
-            .location = 2,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, modelmat.m[8])
-        },
-        {
-            .location = 3,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, modelmat.m[12])
-        },
-        {
-            .location = 4,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, mvpmat.m[0])
-        },
-        {
-            .location = 5,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, mvpmat.m[4])
-        },
-        {
-            .location = 6,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, mvpmat.m[8])
-        },
-        {
-            .location = 7,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, mvpmat.m[12])
-        },
-        {
-            .location = 8,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, tbnmat.m[0])
-        },
-        {
-            .location = 9,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, tbnmat.m[3])
-        },
-        {
-            .location = 10,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, tbnmat.m[6])
-        },
-        {
-            .location = 11,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, color.tl)
-        },
-        {
-            .location = 12,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, color.bl)
-        },
-        {
-            .location = 13,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, color.br)
-        },
-        {
-            .location = 14,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
-            .offset   = offsetof(FG_Quad3In, color.tr)
-        },
-        {
-            .location = 15,
-            .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
-            .offset   = offsetof(FG_Quad3In, coords.tl)
-        }
+    SDL_GPUVertexAttribute             vertattr                     = {
+        .format = SDL_GPU_VERTEXELEMENTFORMAT_UINT
     };
     SDL_GPUGraphicsPipelineCreateInfo  info                         = {
         .vertex_input_state  = {
             .vertex_buffer_descriptions = &(SDL_GPUVertexBufferDescription){
-                .pitch      = sizeof(FG_Quad3In),
+                .pitch      = sizeof(Uint32),
                 .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE
             },
             .num_vertex_buffers         = 1,
-            .vertex_attributes          = vertattrs,
-            .num_vertex_attributes      = SDL_arraysize(vertattrs)
+            .vertex_attributes          = &vertattr,
+            .num_vertex_attributes      = 1
         },
         .rasterizer_state    = {
             .cull_mode         = SDL_GPU_CULLMODE_BACK,
@@ -197,34 +219,68 @@ FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device)
         }
     };
 
-    for (i = 0; i != SDL_arraysize(targbuf_descs); ++i) {
-        targbuf_descs[i].format = FG_GBUF_FORMAT;
-    }
-
     if (!self) return NULL;
 
     self->device = device;
+    self->path   = path;
+
+    /* forward rendering lights quads straight into one swapchain target */
+    if (self->path == FG_RENDERPATH_FORWARD) {
+        layout_count                       = 1;
+        targbuf_count                      = 1;
+        info.target_info.num_color_targets = targbuf_count;
+    }
 
     self->vertshdr = FG_LoadShader(
-        self->device, "quad3.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 0, 0);
+        self->device, "quad3.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1, 1);
     if (!self->vertshdr) {
         FG_DestroyQuad3Stage(self);
         return NULL;
     }
 
-    self->fragshdr = FG_LoadShader(
-        self->device,
-        "quad3.frag",
-        SDL_GPU_SHADERSTAGE_FRAGMENT,
-        SDL_arraysize(self->sampler_binds),
-        0,
-        0
-    );
-    if (!self->fragshdr) {
+    for (i = 0; i != FG_QUAD3_PIPELINES; ++i) {
+        self->fragshdrs[i] = FG_LoadShader(
+            self->device,
+            FG_QUAD3_FRAGSHDRS[self->path][i],
+            SDL_GPU_SHADERSTAGE_FRAGMENT,
+            SDL_arraysize(self->sampler_binds),
+            self->path == FG_RENDERPATH_FORWARD ? FG_SHADING_SSBOS : 0,
+            self->path == FG_RENDERPATH_FORWARD ? 1 : 0
+        );
+        if (!self->fragshdrs[i]) {
+            FG_DestroyQuad3Stage(self);
+            return NULL;
+        }
+
+        self->unlit_fragshdrs[i] = FG_LoadShader(
+            self->device,
+            FG_QUAD3_UNLIT_FRAGSHDRS[i],
+            SDL_GPU_SHADERSTAGE_FRAGMENT,
+            SDL_arraysize(self->sampler_binds),
+            0,
+            0
+        );
+        if (!self->unlit_fragshdrs[i]) {
+            FG_DestroyQuad3Stage(self);
+            return NULL;
+        }
+    }
+
+    self->clear_vertshdr = FG_LoadShader(
+        self->device, "viewport.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 0, 0);
+    if (!self->clear_vertshdr) {
         FG_DestroyQuad3Stage(self);
         return NULL;
     }
 
+    self->clear_fragshdr = FG_LoadShader(
+        self->device, "depth_clear.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0, 0);
+    if (!self->clear_fragshdr) {
+        FG_DestroyQuad3Stage(self);
+        return NULL;
+    }
+
+    self->ssbo_info.usage    = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
     self->vertbuf_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
 
     self->sampler_binds[0].sampler = SDL_CreateGPUSampler(
@@ -243,11 +299,69 @@ FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device)
         }
     }
 
-    info.vertex_shader   = self->vertshdr;
-    info.fragment_shader = self->fragshdr;
+    info.vertex_shader = self->vertshdr;
+
+    for (i = 0; i != layout_count; ++i) {
+        for (j = 0; j != SDL_arraysize(targbuf_descs); ++j) {
+            targbuf_descs[j].format = FG_GetGBufFormat((FG_GBufferLayout)i, j);
+        }
+        if (self->path == FG_RENDERPATH_FORWARD) targbuf_descs[0].format = targbuf_fmt;
+
+        for (j = 0; j != FG_QUAD3_PIPELINES; ++j) {
+            info.fragment_shader = self->fragshdrs[j];
+
+            self->pipelines[i][j] = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+            if (!self->pipelines[i][j]) {
+                FG_DestroyQuad3Stage(self);
+                return NULL;
+            }
+        }
+    }
+
+    /* unlit cameras draw albedo times color straight into the swapchain */
+    info.target_info.num_color_targets = 1;
+    targbuf_descs[0].format            = targbuf_fmt;
+
+    for (i = 0; i != FG_QUAD3_PIPELINES; ++i) {
+        info.fragment_shader = self->unlit_fragshdrs[i];
+
+        self->unlit_pipelines[i] = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+        if (!self->unlit_pipelines[i]) {
+            FG_DestroyQuad3Stage(self);
+            return NULL;
+        }
+    }
+
+    /* resets the depth of one viewport, leaving the color targets alone */
+    info.vertex_shader                  = self->clear_vertshdr;
+    info.fragment_shader                = self->clear_fragshdr;
+    info.vertex_input_state             = (SDL_GPUVertexInputState){ 0 };
+    info.rasterizer_state.cull_mode     = SDL_GPU_CULLMODE_NONE;
+    info.depth_stencil_state.compare_op = SDL_GPU_COMPAREOP_ALWAYS;
+    info.target_info.num_color_targets  = targbuf_count;
 
-    self->pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
-    if (!self->pipeline) {
+    for (i = 0; i != SDL_arraysize(targbuf_descs); ++i) {
+        targbuf_descs[i].blend_state.enable_color_write_mask = true;
+    }
+
+    for (i = 0; i != layout_count; ++i) {
+        for (j = 0; j != SDL_arraysize(targbuf_descs); ++j) {
+            targbuf_descs[j].format = FG_GetGBufFormat((FG_GBufferLayout)i, j);
+        }
+        if (self->path == FG_RENDERPATH_FORWARD) targbuf_descs[0].format = targbuf_fmt;
+
+        self->clear_pipelines[i] = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+        if (!self->clear_pipelines[i]) {
+            FG_DestroyQuad3Stage(self);
+            return NULL;
+        }
+    }
+
+    info.target_info.num_color_targets = 1;
+    targbuf_descs[0].format            = targbuf_fmt;
+
+    self->unlit_clear_pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+    if (!self->unlit_clear_pipeline) {
         FG_DestroyQuad3Stage(self);
         return NULL;
     }
@@ -255,168 +369,652 @@ FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device)
     return self;
 }
 
-FG_Quad3Batch * FG_GetQuad3Batch(FG_Quad3Stage *self, const FG_Material *material)
+Uint32 FG_GetMaterialID(FG_Quad3Stage     *self,
+                        const FG_Material *material,
+                        Uint32            *material_count)
+{
+    FG_Material      textures = { 0 };
+    Uint64           hash     = 0;
+    Uint8            i        = 0;
+    FG_MaterialSlot *slot     = NULL;
+
+    if (material) textures = *material;
+
+    for (i = 0; i != SDL_arraysize(textures.iter); ++i) {
+        hash = (hash ^ (Uint64)textures.iter[i]) * SDL_UINT64_C(0x9E3779B97F4A7C15);
+    }
+
+    slot = self->material_slots + ((hash >> 32) & (self->slot_capacity - 1));
+
+    while (slot->stamp == self->stamp) {
+        if (!SDL_memcmp(&slot->material, &textures, sizeof(textures))) return slot->id;
+        if (++slot == self->material_slots + self->slot_capacity) {
+            slot = self->material_slots;
+        }
+    }
+
+    slot->material                   = textures;
+    slot->id                         = *material_count;
+    slot->stamp                      = self->stamp;
+    self->materials[*material_count] = textures;
+
+    return (*material_count)++;
+}
+
+void FG_SortQuad3Keys(FG_Quad3Stage *self, Uint32 count)
 {
-    Uint32         i     = 0;
-    FG_Quad3Batch *batch = self->batches_begin + (Uint64)material % self->capacity;
-
-    for (i = 0; i != self->capacity; ++i) {
-        if (!batch->capacity) {
-            batch->material    = material;
-            batch->offset      = 0;
-            batch->count       = 0;
-            batch->next        = self->batches_head;
-            self->batches_head = batch;
-            return batch;
+    Uint32  histograms[sizeof(*self->keys)][256] = { 0 };
+    Uint32  i                                    = 0;
+    Uint8   pass                                 = 0;
+    Uint32  offset                               = 0;
+    Uint32  digit_count                          = 0;
+    Uint64 *keys                                 = NULL;
+    Uint32 *values                               = NULL;
+
+    for (i = 0; i != count; ++i) {
+        for (pass = 0; pass != SDL_arraysize(histograms); ++pass) {
+            ++histograms[pass][(self->keys[i] >> pass * 8) & 0xFF];
         }
-        if (batch->material == material) return batch;
-        if (++batch == self->batches_end) batch = self->batches_begin;
     }
 
-    return NULL;
+    for (pass = 0; pass != SDL_arraysize(histograms); ++pass) {
+        if (histograms[pass][(self->keys[0] >> pass * 8) & 0xFF] == count) continue;
+
+        for (i = 0, offset = 0; i != SDL_arraysize(histograms[pass]); ++i) {
+            digit_count          = histograms[pass][i];
+            histograms[pass][i]  = offset;
+            offset              += digit_count;
+        }
+
+        for (i = 0; i != count; ++i) {
+            offset = histograms[pass][(self->keys[i] >> pass * 8) & 0xFF]++;
+
+            self->sorted_keys[offset]   = self->keys[i];
+            self->sorted_values[offset] = self->values[i];
+        }
+
+        keys                = self->keys;
+        self->keys          = self->sorted_keys;
+        self->sorted_keys   = keys;
+        values              = self->values;
+        self->values        = self->sorted_values;
+        self->sorted_values = values;
+    }
+}
+
+void FG_CullQuad3s(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_Quad3CullJob *job        = data;
+    FG_Quad3Stage         *self       = job->stage;
+    const FG_Mat4         *vpmat      = job->vpmat;
+    Uint32                 i          = 0;
+    const FG_Quad3        *quad3      = NULL;
+    float                  depth      = 0.0F;
+    Uint32                 depth_bits = 0;
+    Uint32                 count      = 0;
+    Uint32                 culls      = 0;
+
+    for (i = begin; i != end; ++i) {
+        if (i < self->pool_count && self->free_flags[i]) continue;
+
+        quad3 = FG_GetQuad3(self, job->info, i);
+        if (!(quad3->mask & job->camera->mask)) continue;
+        if (!FG_IntersectsFrustum(
+            &job->frustum,
+            &quad3->transf.transl,
+            0.5F * SDL_sqrtf(quad3->transf.scale.x * quad3->transf.scale.x
+                           + quad3->transf.scale.y * quad3->transf.scale.y)
+        )) {
+            ++culls;
+            continue;
+        }
+
+        depth = quad3->opaque
+            ? vpmat->m[3] * quad3->transf.transl.x
+            + vpmat->m[7] * quad3->transf.transl.y
+            + vpmat->m[11] * quad3->transf.transl.z
+            + vpmat->m[15]
+            : 0.0F;
+        depth = SDL_max(depth, 0.0F);
+        SDL_memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+        /* pipeline: 63..56, material: 55..32, depth: 31..0 */
+        self->keys[begin + count]   = (Uint64)!quad3->opaque << 56
+                                    | (Uint64)self->material_ids[i] << 32
+                                    | depth_bits >> 16;
+        self->values[begin + count] = i;
+        ++count;
+    }
+
+    self->chunk_counts[chunk] = count;
+    self->chunk_culls[chunk]  = culls;
+}
+
+void FG_PackQuad3s(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_Quad3PackJob *job = data;
+
+    (void)chunk;
+
+    FG_SetQuad3Ins(job->quad3s + begin, end - begin, job->quad3ins + begin);
+}
+
+void FG_PackImmediateQuad3s(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_Quad3PackJob *job = data;
+    Uint32                 i   = 0;
+
+    (void)chunk;
+
+    for (i = begin; i != end; ++i) {
+        FG_SetQuad3Ins(job->quad3s + job->slots[i], 1, job->quad3ins + i);
+    }
+}
+
+Sint32 FG_SlotComparator(const void *lhs, const void *rhs)
+{
+    return (*(const Uint32 *)lhs > *(const Uint32 *)rhs)
+         - (*(const Uint32 *)lhs < *(const Uint32 *)rhs);
+}
+
+const FG_Quad3 * FG_GetQuad3(const FG_Quad3Stage         *self,
+                             const FG_Quad3StageDrawInfo *info,
+                             Uint32                       index)
+{
+    return index < self->pool_count
+        ? self->pool + index
+        : info->quad3s + index - self->pool_count;
+}
+
+bool FG_FindQuad3Slot(const FG_Quad3Stage *self, Uint32 handle, Uint32 *slot)
+{
+    *slot = handle & FG_QUAD3_SLOT_MASK;
+
+    return *slot < self->pool_count
+        && !self->free_flags[*slot]
+        && self->generations[*slot] == handle >> FG_QUAD3_SLOT_BITS;
+}
+
+bool FG_Quad3StageCreateQuad3(FG_Quad3Stage  *self,
+                              const FG_Quad3 *quad3,
+                              Uint32         *handle)
+{
+    Uint32    capacity    = 0;
+    FG_Quad3 *pool        = NULL;
+    Uint32   *free_slots  = NULL;
+    Uint32   *dirties     = NULL;
+    bool     *dirty_flags = NULL;
+    bool     *free_flags  = NULL;
+    Uint8    *generations = NULL;
+    Uint32    slot        = 0;
+
+    if (self->free_count) {
+        slot                   = self->free_slots[--self->free_count];
+        self->free_flags[slot] = false;
+        *handle = (Uint32)self->generations[slot] << FG_QUAD3_SLOT_BITS | slot;
+        FG_Quad3StageUpdateQuad3(self, *handle, quad3);
+        return true;
+    }
+
+    if (self->pool_count == FG_QUAD3_SLOT_MASK) {
+        return SDL_SetError("FlyGPU: Too many quads!");
+    }
+
+    if (self->pool_count == self->pool_capacity) {
+        capacity = self->pool_capacity ? 2 * self->pool_capacity : 64;
+
+        pool = SDL_realloc(self->pool, capacity * sizeof(*pool));
+        if (!pool) return false;
+        self->pool = pool;
+
+        free_slots = SDL_realloc(self->free_slots, capacity * sizeof(*free_slots));
+        if (!free_slots) return false;
+        self->free_slots = free_slots;
+
+        dirties = SDL_realloc(self->dirties, capacity * sizeof(*dirties));
+        if (!dirties) return false;
+        self->dirties = dirties;
+
+        dirty_flags = SDL_realloc(self->dirty_flags, capacity * sizeof(*dirty_flags));
+        if (!dirty_flags) return false;
+        self->dirty_flags = dirty_flags;
+
+        SDL_memset(self->dirty_flags + self->pool_capacity,
+                   0,
+                   (capacity - self->pool_capacity) * sizeof(*self->dirty_flags));
+
+        free_flags = SDL_realloc(self->free_flags, capacity * sizeof(*free_flags));
+        if (!free_flags) return false;
+        self->free_flags = free_flags;
+
+        SDL_memset(self->free_flags + self->pool_capacity,
+                   0,
+                   (capacity - self->pool_capacity) * sizeof(*self->free_flags));
+
+        generations = SDL_realloc(self->generations, capacity * sizeof(*generations));
+        if (!generations) return false;
+        self->generations = generations;
+
+        SDL_memset(self->generations + self->pool_capacity,
+                   0,
+                   (capacity - self->pool_capacity) * sizeof(*self->generations));
+
+        self->pool_capacity = capacity;
+    }
+
+    *handle = self->pool_count++;
+    FG_Quad3StageUpdateQuad3(self, *handle, quad3);
+
+    return true;
+}
+
+void FG_Quad3StageUpdateQuad3(FG_Quad3Stage  *self,
+                              Uint32          handle,
+                              const FG_Quad3 *quad3)
+{
+    Uint32 slot = 0;
+
+    /* stale handles are ignored rather than written to a reused slot */
+    if (!FG_FindQuad3Slot(self, handle, &slot)) return;
+
+    self->pool[slot] = *quad3;
+
+    if (self->dirty_flags[slot]) return;
+
+    self->dirty_flags[slot]            = true;
+    self->dirties[self->dirty_count++] = slot;
+}
+
+void FG_Quad3StageDestroyQuad3(FG_Quad3Stage *self, Uint32 handle)
+{
+    Uint32 slot = 0;
+
+    /* a second destroy would hand the same slot out twice */
+    if (!FG_FindQuad3Slot(self, handle, &slot)) return;
+
+    /* the material may be released once its last quad is destroyed */
+    self->pool[slot].material            = NULL;
+    self->pool[slot].mask                = 0;
+    self->free_flags[slot]               = true;
+    ++self->generations[slot];
+    self->free_slots[self->free_count++] = slot;
+}
+
+void FG_Quad3StageSetGBufferLayout(FG_Quad3Stage *self, FG_GBufferLayout layout)
+{
+    self->layout = layout;
 }
 
 bool FG_Quad3StageCopy(FG_Quad3Stage               *self,
-                       SDL_GPUCopyPass             *cpypass,
-                       Uint32                       mask,
-                       const FG_Mat4               *vpmat,
-                       const FG_Quad3StageDrawInfo *info)
+                       FG_Staging                  *staging,
+                       FG_Jobs                     *jobs,
+                       Uint32                       camera_count,
+                       const FG_Camera            **cameras,
+                       const FG_Mat4               *vpmats,
+                       const FG_Quad3StageDrawInfo *info,
+                       FG_RendererStats            *stats)
 {
-    FG_Quad3Batch *batch    = NULL;
-    Uint32         i        = 0;
-    Uint32         count    = 0;
-    Uint32         size     = 0;
-    FG_Quad3In    *transmem = NULL;
-    Uint32         j        = 0;
-
-    if (self->capacity < info->count) {
-        self->quad3s = SDL_realloc(self->quad3s, info->count * sizeof(*self->quad3s));
-        if (!self->quad3s) return false;
-
-        self->batches_begin = SDL_realloc(
-            self->batches_begin, info->count * sizeof(*self->batches_begin));
-        if (!self->batches_begin) return false;
-
-        self->batches_end = self->batches_begin + info->count;
-
-        for (batch = self->batches_begin + self->capacity;
-             batch != self->batches_end;
-             ++batch) {
-            batch->capacity = 0;
+    Uint32           quad3_count    = self->pool_count + info->count;
+    Uint32           chunk_count    = FG_GetJobChunkCount(quad3_count, FG_QUAD3_GRAIN);
+    Uint32           material_count = 0;
+    FG_Quad3CullJob  cull_job       = { .stage = self, .info = info };
+    FG_Quad3PackJob  pack_job       = { 0 };
+    Uint32           i              = 0;
+    Uint32           j              = 0;
+    Uint32           k              = 0;
+    Uint32           count          = 0;
+    Uint32           total          = 0;
+    Uint32           draw_count     = 0;
+    Uint32           visible_count  = 0;
+    Uint32           size           = 0;
+    bool             refill         = false;
+    Uint32          *remaps         = NULL;
+    Uint32          *slots          = NULL;
+    FG_Quad3In      *transmem       = NULL;
+
+    if (self->capacity < quad3_count) {
+        self->material_ids = SDL_realloc(
+            self->material_ids, quad3_count * sizeof(*self->material_ids));
+        if (!self->material_ids) return false;
+
+        self->materials = SDL_realloc(
+            self->materials, quad3_count * sizeof(*self->materials));
+        if (!self->materials) return false;
+
+        self->keys = SDL_realloc(self->keys, quad3_count * sizeof(*self->keys));
+        if (!self->keys) return false;
+
+        self->sorted_keys = SDL_realloc(
+            self->sorted_keys, quad3_count * sizeof(*self->sorted_keys));
+        if (!self->sorted_keys) return false;
+
+        self->values = SDL_realloc(self->values, quad3_count * sizeof(*self->values));
+        if (!self->values) return false;
+
+        self->sorted_values = SDL_realloc(
+            self->sorted_values, quad3_count * sizeof(*self->sorted_values));
+        if (!self->sorted_values) return false;
+
+        self->chunk_counts = SDL_realloc(
+            self->chunk_counts, chunk_count * sizeof(*self->chunk_counts));
+        if (!self->chunk_counts) return false;
+
+        self->chunk_culls = SDL_realloc(
+            self->chunk_culls, chunk_count * sizeof(*self->chunk_culls));
+        if (!self->chunk_culls) return false;
+
+        self->capacity = quad3_count;
+    }
+
+    if (self->slot_capacity < 2 * quad3_count) {
+        if (!self->slot_capacity) self->slot_capacity = 64;
+        while (self->slot_capacity < 2 * quad3_count) self->slot_capacity *= 2;
+
+        SDL_free(self->material_slots);
+        self->material_slots = SDL_calloc(
+            self->slot_capacity, sizeof(*self->material_slots));
+        if (!self->material_slots) return false;
+
+        self->stamp = 0;
+    }
+
+    if (!++self->stamp) {
+        SDL_memset(self->material_slots,
+                   0,
+                   self->slot_capacity * sizeof(*self->material_slots));
+
+        self->stamp = 1;
+    }
+
+    for (i = 0; i != quad3_count; ++i) {
+        if (i < self->pool_count && self->free_flags[i]) continue;
+
+        self->material_ids[i] = FG_GetMaterialID(
+            self, FG_GetQuad3(self, info, i)->material, &material_count);
+    }
+
+    if (self->camera_capacity < camera_count + 1) {
+        self->draw_offsets = SDL_realloc(
+            self->draw_offsets, (camera_count + 1) * sizeof(*self->draw_offsets));
+        if (!self->draw_offsets) return false;
+
+        self->camera_capacity = camera_count + 1;
+    }
+
+    for (i = 0; i != camera_count; ++i) {
+        self->draw_offsets[i] = draw_count;
+
+        cull_job.camera = cameras[i];
+        cull_job.vpmat  = vpmats + i;
+        FG_SetFrustum(vpmats + i, &cull_job.frustum);
+
+        FG_JobsParallelFor(
+            jobs, quad3_count, FG_QUAD3_GRAIN, FG_CullQuad3s, &cull_job);
+
+        /* compact in chunk order so the sort input never depends on scheduling */
+        for (j = 0, count = 0; j != chunk_count; ++j) {
+            SDL_memmove(self->keys + count,
+                        self->keys + j * FG_QUAD3_GRAIN,
+                        self->chunk_counts[j] * sizeof(*self->keys));
+            SDL_memmove(self->values + count,
+                        self->values + j * FG_QUAD3_GRAIN,
+                        self->chunk_counts[j] * sizeof(*self->values));
+
+            count                     += self->chunk_counts[j];
+            stats->culled_quad3_count += self->chunk_culls[j];
+        }
+
+        stats->visible_quad3_count += count;
+
+        if (!count) continue;
+
+        FG_SortQuad3Keys(self, count);
+
+        if (self->index_capacity < total + count) {
+            self->indices = SDL_realloc(
+                self->indices, (total + count) * sizeof(*self->indices));
+            if (!self->indices) return false;
+
+            self->index_capacity = total + count;
         }
 
-        self->capacity = info->count;
+        SDL_memcpy(self->indices + total, self->values, count * sizeof(*self->values));
+
+        for (j = 0; j != count; j = k) {
+            for (k = j + 1; k != count; ++k) {
+                if ((self->keys[k] ^ self->keys[j]) >> 32) break;
+            }
+
+            if (self->draw_capacity == draw_count) {
+                self->draw_capacity = draw_count ? 2 * draw_count : material_count;
+
+                self->draws = SDL_realloc(
+                    self->draws, self->draw_capacity * sizeof(*self->draws));
+                if (!self->draws) return false;
+            }
+
+            self->draws[draw_count].pipeline = cameras[i]->unlit
+                ? self->unlit_pipelines[self->keys[j] >> 56]
+                : self->pipelines[self->layout][self->keys[j] >> 56];
+            self->draws[draw_count].material = self->materials
+                                             + ((self->keys[j] >> 32) & 0xFFFFFF);
+            self->draws[draw_count].offset   = total + j;
+            self->draws[draw_count].count    = k - j;
+            ++draw_count;
+        }
+
+        total += count;
     }
 
-    for (batch = self->batches_head; batch; batch = batch->next) batch->capacity = 0;
+    self->draw_offsets[camera_count] = draw_count;
+
+    if (!total) return true;
 
-    self->batches_head = NULL;
+    /* the sort scratch is free again, so it maps visible immediates to packed ones */
+    remaps = self->sorted_values;
+    slots  = self->values;
 
-    for (i = 0; i != info->count; ++i) {
-        if (info->quad3s[i].mask & mask) {
-            self->quad3s[count] = info->quad3s + i;
-            ++FG_GetQuad3Batch(self, self->quad3s[count++]->material)->capacity;
+    if (info->count) {
+        SDL_memset(remaps, 0, info->count * sizeof(*remaps));
+
+        for (i = 0; i != total; ++i) {
+            if (self->pool_count <= self->indices[i]) {
+                remaps[self->indices[i] - self->pool_count] = 1;
+            }
+        }
+
+        for (i = 0; i != info->count; ++i) {
+            if (!remaps[i]) continue;
+
+            remaps[i]              = visible_count;
+            slots[visible_count++] = i;
+        }
+
+        for (i = 0; i != total; ++i) {
+            if (self->pool_count <= self->indices[i]) {
+                self->indices[i] = self->pool_count
+                                 + remaps[self->indices[i] - self->pool_count];
+            }
         }
     }
 
-    if (!self->batches_head) return true;
+    size = (self->pool_count + visible_count) * sizeof(*transmem);
+
+    if (self->ssbo_info.size < size) {
+        self->ssbo_info.size = SDL_max(2 * self->ssbo_info.size, size);
 
-    for (batch = self->batches_head; batch->next; batch = batch->next) {
-        batch->next->offset = batch->offset + batch->next->capacity;
+        SDL_ReleaseGPUBuffer(self->device, self->ssbo);
+        self->ssbo = SDL_CreateGPUBuffer(self->device, &self->ssbo_info);
+        if (!self->ssbo) return false;
+
+        refill = true;
     }
 
-    size = count * sizeof(*transmem);
+    size = total * sizeof(*self->indices);
 
     if (self->vertbuf_info.size < size) {
-        self->vertbuf_info.size = size;
+        self->vertbuf_info.size = SDL_max(2 * self->vertbuf_info.size, size);
 
         SDL_ReleaseGPUBuffer(self->device, self->vertbuf_bind.buffer);
         self->vertbuf_bind.buffer = SDL_CreateGPUBuffer(
             self->device, &self->vertbuf_info);
         if (!self->vertbuf_bind.buffer) return false;
+    }
 
-        SDL_ReleaseGPUTransferBuffer(self->device, self->transbuf);
-        self->transbuf = SDL_CreateGPUTransferBuffer(
-            self->device,
-            &(SDL_GPUTransferBufferCreateInfo){ .size = self->vertbuf_info.size }
+    if (refill) {
+        for (i = 0; i != self->pool_count; ++i) self->dirties[i] = i;
+
+        self->dirty_count = self->pool_count;
+    }
+
+    SDL_qsort(
+        self->dirties, self->dirty_count, sizeof(*self->dirties), FG_SlotComparator);
+
+    for (i = 0; i != self->dirty_count; i = j) {
+        for (j = i + 1; j != self->dirty_count; ++j) {
+            if (self->dirties[j] != self->dirties[j - 1] + 1) break;
+        }
+
+        count    = j - i;
+        transmem = FG_StagingUploadToBuffer(
+            staging,
+            self->ssbo,
+            self->dirties[i] * sizeof(*transmem),
+            count * sizeof(*transmem)
         );
-        if (!self->transbuf) return false;
+        if (!transmem) return false;
+
+        pack_job.quad3s   = self->pool + self->dirties[i];
+        pack_job.quad3ins = transmem;
+        FG_JobsParallelFor(jobs, count, FG_QUAD3_GRAIN, FG_PackQuad3s, &pack_job);
+    }
+
+    for (i = 0; i != self->dirty_count; ++i) {
+        self->dirty_flags[self->dirties[i]] = false;
     }
 
-    transmem = SDL_MapGPUTransferBuffer(self->device, self->transbuf, true);
+    self->dirty_count = 0;
+
+    if (visible_count) {
+        transmem = FG_StagingUploadToBuffer(
+            staging,
+            self->ssbo,
+            self->pool_count * sizeof(*transmem),
+            visible_count * sizeof(*transmem)
+        );
+        if (!transmem) return false;
+
+        pack_job.quad3s   = info->quad3s;
+        pack_job.slots    = slots;
+        pack_job.quad3ins = transmem;
+        FG_JobsParallelFor(
+            jobs, visible_count, FG_QUAD3_GRAIN, FG_PackImmediateQuad3s, &pack_job);
+    }
+
+    transmem = FG_StagingUploadToBuffer(
+        staging, self->vertbuf_bind.buffer, 0, size);
     if (!transmem) return false;
 
-    for (i = 0; i != count; ++i) {
-        batch = FG_GetQuad3Batch(self, self->quad3s[i]->material);
-        j     = batch->offset + batch->count++;
-        FG_SetModelMat4(&self->quad3s[i]->transf, &transmem[j].modelmat);
-        FG_MulMat4s(vpmat, &transmem[j].modelmat, &transmem[j].mvpmat);
-        FG_SetTBNMat3(self->quad3s[i]->transf.rotation, &transmem[j].tbnmat);
-        transmem[j].color  = self->quad3s[i]->color;
-        transmem[j].coords = self->quad3s[i]->coords;
-    }
-
-    SDL_UnmapGPUTransferBuffer(self->device, self->transbuf);
-
-    SDL_UploadToGPUBuffer(
-        cpypass,
-        &(SDL_GPUTransferBufferLocation){ .transfer_buffer = self->transbuf },
-        &(SDL_GPUBufferRegion){
-            .buffer = self->vertbuf_bind.buffer,
-            .size   = self->vertbuf_info.size
-        },
-        false
-    );
+    SDL_memcpy(transmem, self->indices, size);
 
     return true;
 }
 
-void FG_Quad3StageDraw(FG_Quad3Stage     *self,
-                       SDL_GPURenderPass *rndrpass,
-                       const FG_Material *fallback)
+void FG_Quad3StageClear(FG_Quad3Stage     *self,
+                        SDL_GPURenderPass *rndrpass,
+                        const FG_Camera   *camera)
+{
+    SDL_BindGPUGraphicsPipeline(rndrpass,
+                                camera->unlit
+                                    ? self->unlit_clear_pipeline
+                                    : self->clear_pipelines[self->layout]);
+    SDL_DrawGPUPrimitives(rndrpass, 3, 1, 0, 0);
+}
+
+void FG_Quad3StageDraw(FG_Quad3Stage        *self,
+                       SDL_GPUCommandBuffer *cmdbuf,
+                       SDL_GPURenderPass    *rndrpass,
+                       Uint32                camera,
+                       const FG_Mat4        *vpmat,
+                       const FG_Material    *fallback)
 {
-    const FG_Quad3Batch *batch = self->batches_head;
-    Uint8                i     = 0;
+    const FG_Quad3Draw      *draw     = NULL;
+    const FG_Quad3Draw      *end      = NULL;
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+    Uint8                    i        = 0;
 
-    if (!batch) return;
+    if (self->draw_offsets[camera] == self->draw_offsets[camera + 1]) return;
 
+    draw = self->draws + self->draw_offsets[camera];
+    end  = self->draws + self->draw_offsets[camera + 1];
+
+    SDL_PushGPUVertexUniformData(cmdbuf, 0, vpmat, sizeof(*vpmat));
     SDL_BindGPUVertexBuffers(rndrpass, 0, &self->vertbuf_bind, 1);
-    SDL_BindGPUGraphicsPipeline(rndrpass, self->pipeline);
-
-    for (batch = self->batches_head; batch; batch = batch->next) {
-        if (batch->material) {
-            for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
-                self->sampler_binds[i].texture = batch->material->iter[i]
-                    ? batch->material->iter[i]
-                    : fallback->iter[i];
-            }
+    SDL_BindGPUVertexStorageBuffers(rndrpass, 0, &self->ssbo, 1);
+
+    for (; draw != end; ++draw) {
+        if (pipeline != draw->pipeline) {
+            pipeline = draw->pipeline;
+            SDL_BindGPUGraphicsPipeline(rndrpass, pipeline);
         }
-        else {
-            for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
-                self->sampler_binds[i].texture = fallback->iter[i];
-            }
+
+        for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
+            self->sampler_binds[i].texture = draw->material->iter[i]
+                ? draw->material->iter[i]
+                : fallback->iter[i];
         }
 
         SDL_BindGPUFragmentSamplers(
             rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
-        SDL_DrawGPUPrimitives(rndrpass, 6, batch->count, 0, batch->offset);
+        SDL_DrawGPUPrimitives(rndrpass, 6, draw->count, 0, draw->offset);
     }
 }
 
 void FG_DestroyQuad3Stage(FG_Quad3Stage *self)
 {
     Uint8 i = 0;
+    Uint8 j = 0;
 
     if (!self) return;
-    SDL_ReleaseGPUGraphicsPipeline(self->device, self->pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(self->device, self->unlit_clear_pipeline);
+    for (i = 0; i != FG_QUAD3_PIPELINES; ++i) {
+        SDL_ReleaseGPUGraphicsPipeline(self->device, self->unlit_pipelines[i]);
+    }
+    for (i = 0; i != FG_GBUF_LAYOUTS; ++i) {
+        SDL_ReleaseGPUGraphicsPipeline(self->device, self->clear_pipelines[i]);
+        for (j = 0; j != FG_QUAD3_PIPELINES; ++j) {
+            SDL_ReleaseGPUGraphicsPipeline(self->device, self->pipelines[i][j]);
+        }
+    }
     for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
         SDL_ReleaseGPUSampler(self->device, self->sampler_binds[i].sampler);
     }
-    SDL_ReleaseGPUTransferBuffer(self->device, self->transbuf);
     SDL_ReleaseGPUBuffer(self->device, self->vertbuf_bind.buffer);
-    SDL_free(self->batches_begin);
-    SDL_free(self->quad3s);
-    SDL_ReleaseGPUShader(self->device, self->fragshdr);
+    SDL_ReleaseGPUBuffer(self->device, self->ssbo);
+    SDL_free(self->draw_offsets);
+    SDL_free(self->generations);
+    SDL_free(self->free_flags);
+    SDL_free(self->dirty_flags);
+    SDL_free(self->dirties);
+    SDL_free(self->free_slots);
+    SDL_free(self->pool);
+    SDL_free(self->draws);
+    SDL_free(self->indices);
+    SDL_free(self->chunk_culls);
+    SDL_free(self->chunk_counts);
+    SDL_free(self->sorted_values);
+    SDL_free(self->values);
+    SDL_free(self->sorted_keys);
+    SDL_free(self->keys);
+    SDL_free(self->materials);
+    SDL_free(self->material_slots);
+    SDL_free(self->material_ids);
+    SDL_ReleaseGPUShader(self->device, self->clear_fragshdr);
+    SDL_ReleaseGPUShader(self->device, self->clear_vertshdr);
+    for (i = 0; i != FG_QUAD3_PIPELINES; ++i) {
+        SDL_ReleaseGPUShader(self->device, self->unlit_fragshdrs[i]);
+        SDL_ReleaseGPUShader(self->device, self->fragshdrs[i]);
+    }
     SDL_ReleaseGPUShader(self->device, self->vertshdr);
     SDL_free(self);
 }
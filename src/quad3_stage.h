@@ -25,7 +25,9 @@
 #define FLYGPU_QUAD3_STAGE_H
 
 #include "../include/flygpu/flygpu.h"
+#include "jobs.h"
 #include "linalg.h"
+#include "staging.h"
 
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_stdinc.h>
@@ -34,17 +36,43 @@
 
 typedef struct FG_Quad3Stage FG_Quad3Stage;
 
-FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice *device);
+SDL_GPUTextureFormat FG_GetGBufFormat(FG_GBufferLayout layout, Uint8 index);
+
+FG_Quad3Stage * FG_CreateQuad3Stage(SDL_GPUDevice        *device,
+                                    FG_RenderPath         path,
+                                    SDL_GPUTextureFormat  targbuf_fmt);
+
+bool FG_Quad3StageCreateQuad3(FG_Quad3Stage  *self,
+                              const FG_Quad3 *quad3,
+                              Uint32         *handle);
+
+void FG_Quad3StageUpdateQuad3(FG_Quad3Stage  *self,
+                              Uint32          handle,
+                              const FG_Quad3 *quad3);
+
+void FG_Quad3StageDestroyQuad3(FG_Quad3Stage *self, Uint32 handle);
+
+void FG_Quad3StageSetGBufferLayout(FG_Quad3Stage *self, FG_GBufferLayout layout);
 
 bool FG_Quad3StageCopy(FG_Quad3Stage               *self,
-                       SDL_GPUCopyPass             *cpypass,
-                       Uint32                       mask,
-                       const FG_Mat4               *vpmat,
-                       const FG_Quad3StageDrawInfo *info);
-
-void FG_Quad3StageDraw(FG_Quad3Stage     *self,
-                       SDL_GPURenderPass *rndrpass,
-                       const FG_Material *fallback);
+                       FG_Staging                  *staging,
+                       FG_Jobs                     *jobs,
+                       Uint32                       camera_count,
+                       const FG_Camera            **cameras,
+                       const FG_Mat4               *vpmats,
+                       const FG_Quad3StageDrawInfo *info,
+                       FG_RendererStats            *stats);
+
+void FG_Quad3StageClear(FG_Quad3Stage     *self,
+                        SDL_GPURenderPass *rndrpass,
+                        const FG_Camera   *camera);
+
+void FG_Quad3StageDraw(FG_Quad3Stage        *self,
+                       SDL_GPUCommandBuffer *cmdbuf,
+                       SDL_GPURenderPass    *rndrpass,
+                       Uint32                camera,
+                       const FG_Mat4        *vpmat,
+                       const FG_Material    *fallback);
 
 void FG_DestroyQuad3Stage(FG_Quad3Stage *self);
 
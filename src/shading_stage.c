@@ -25,7 +25,10 @@
 
 #include "../include/flygpu/flygpu.h"
 #include "config.h"
+#include "jobs.h"
+#include "linalg.h"
 #include "shader.h"
+#include "staging.h"
 
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_stdinc.h>
@@ -33,54 +36,175 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-#define FG_LIGHT_VARIANTS 2
+#define FG_LIGHT_GRAIN   1024
+#define FG_LIGHT_TARGETS 2
+
+typedef struct
+{
+    Uint32 origin[2];
+    Uint32 count[2];
+    Uint32 offset;
+} FG_LightGrid;
+
+typedef struct
+{
+    Uint32 offset;
+    Uint32 count;
+} FG_LightTile;
+
+typedef struct
+{
+    Uint32 left;
+    Uint32 top;
+    Uint32 right;
+    Uint32 bottom;
+} FG_TileRect;
+
+typedef struct
+{
+    FG_AABB rect;
+    Uint32  light;
+} FG_LightVolume;
 
 struct FG_ShadingStage
 {
     SDL_GPUDevice                 *device;
     SDL_GPUShader                 *vertshdr;
     SDL_GPUShader                 *fragshdr;
-    SDL_GPUTextureSamplerBinding   sampler_binds[FG_GBUF_COUNT];
+    SDL_GPUShader                 *volume_vertshdr;
+    SDL_GPUShader                 *volume_fragshdr;
+    SDL_GPUShader                 *lowres_fragshdr;
+    SDL_GPUShader                 *lowres_volume_fragshdr;
+    SDL_GPUShader                 *upsample_fragshdr;
+    SDL_GPUTextureSamplerBinding   sampler_binds[FG_GBUF_COUNT + 1];
+    SDL_GPUTextureSamplerBinding   light_binds[FG_LIGHT_TARGETS];
+    SDL_GPUColorTargetInfo         lighttarg_infos[FG_LIGHT_TARGETS];
     Uint32                         capacity;
-    Uint32                         padding;
+    Uint32                         omnis_size;
     const void                   **lights;
-    SDL_GPUBufferCreateInfo        ssbo_infos[FG_LIGHT_VARIANTS];
-    SDL_GPUBuffer                 *ssbos[FG_LIGHT_VARIANTS];
-    SDL_GPUTransferBuffer         *transbufs[FG_LIGHT_VARIANTS];
+    Uint32                        *chunk_counts;
+    FG_TileRect                   *rects;
+    Uint32                         camera_capacity;
+    Uint32                         tile_capacity;
+    Uint32                         index_capacity;
+    FG_Lighting                    lighting;
+    Uint32                         camera_count;
+    Uint32                         camera_mask;
+    const FG_Camera              **cameras;
+    FG_Frustum                    *frustums;
+    FG_LightGrid                  *grids;
+    FG_LightTile                  *tiles;
+    Uint32                        *indices;
+    Uint32                        *volume_offsets;
+    FG_LightVolume                *volumes;
+    SDL_GPUBufferCreateInfo        ssbo_infos[FG_SHADING_SSBOS];
+    SDL_GPUBufferCreateInfo        vertbuf_info;
+    Uint32                         volume_capacity;
+    SDL_GPUBuffer                 *ssbos[FG_SHADING_SSBOS];
+    SDL_GPUBufferBinding           vertbuf_bind;
     struct
     {
-        FG_Vec3 origo;
-        Uint32  directs_size;
-        FG_Vec3 ambient;
-        Uint32  omnis_size;
-        Uint32  padding[3];
-        float   shine;
+        FG_Mat4      invvp;
+        float        viewport[4];
+        FG_Vec3      origo;
+        Uint32       directs_size;
+        FG_Vec3      ambient;
+        Uint32       mask;
+        FG_LightGrid grid;
+        float        shine;
+        float        scale;
+        Uint32       padding;
     }                              ubo;
     SDL_GPUGraphicsPipeline       *pipeline;
+    SDL_GPUGraphicsPipeline       *volume_pipeline;
+    SDL_GPUGraphicsPipeline       *lowres_pipeline;
+    SDL_GPUGraphicsPipeline       *lowres_volume_pipeline;
+    SDL_GPUGraphicsPipeline       *upsample_pipeline;
 };
 
-typedef bool (SDLCALL *FG_LightFilter)(Uint32 mask, const void *light);
+typedef struct
+{
+    FG_ShadingStage *stage;
+    const Uint8     *src;
+    Uint8           *transmem;
+} FG_LightJob;
 
-static bool SDLCALL FG_AmbientLightFilter(Uint32 mask, const void *light);
+static void SDLCALL FG_FilterDirectLights(void   *data,
+                                          Uint32  chunk,
+                                          Uint32  begin,
+                                          Uint32  end);
 
-static bool SDLCALL FG_OmniLightFilter(Uint32 mask, const void *light);
+static void SDLCALL FG_FilterOmniLights(void   *data,
+                                        Uint32  chunk,
+                                        Uint32  begin,
+                                        Uint32  end);
+
+static void SDLCALL FG_PackDirectLights(void   *data,
+                                        Uint32  chunk,
+                                        Uint32  begin,
+                                        Uint32  end);
+
+static void SDLCALL FG_PackOmniLights(void   *data,
+                                      Uint32  chunk,
+                                      Uint32  begin,
+                                      Uint32  end);
+
+static void * FG_ShadingStageReserve(FG_ShadingStage         *self,
+                                     FG_Staging              *staging,
+                                     SDL_GPUBufferCreateInfo *info,
+                                     SDL_GPUBuffer          **buffer,
+                                     Uint32                   size);
 
 static bool FG_ShadingStageSubCopy(FG_ShadingStage *self,
-                                   SDL_GPUCopyPass *cpypass,
+                                   FG_Staging      *staging,
+                                   FG_Jobs         *jobs,
                                    Uint8            dst,
                                    Uint32          *dst_size,
                                    const void      *src,
                                    Uint32           src_count,
                                    Uint8            size,
-                                   Uint32           mask,
-                                   FG_LightFilter   filter);
+                                   FG_JobFunction   filter,
+                                   FG_JobFunction   pack);
+
+static bool FG_GetLightBounds(const FG_OmniLight *omni,
+                              const FG_Camera    *camera,
+                              const FG_Mat4      *vpmat,
+                              FG_AABB            *bounds);
+
+static bool FG_ShadingStageBin(FG_ShadingStage       *self,
+                               FG_Staging            *staging,
+                               Uint32                 camera_count,
+                               const FG_Camera      **cameras,
+                               const SDL_GPUViewport *viewports,
+                               const FG_Mat4         *vpmats);
+
+static bool FG_ShadingStageCullVolumes(FG_ShadingStage  *self,
+                                       FG_Staging       *staging,
+                                       Uint32            camera_count,
+                                       const FG_Camera **cameras,
+                                       const FG_Mat4    *vpmats);
+
+static bool FG_ShadingStageSetUniforms(FG_ShadingStage       *self,
+                                       Uint32                 index,
+                                       const SDL_GPUViewport *viewport,
+                                       const FG_Mat4         *vpmat,
+                                       const FG_Camera       *camera);
 
 FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
                                         SDL_GPUTextureFormat  targbuf_fmt)
 {
-    FG_ShadingStage                   *self = SDL_calloc(1, sizeof(*self));
-    Uint8                              i    = 0;
-    SDL_GPUGraphicsPipelineCreateInfo  info = {
+    FG_ShadingStage                   *self        = SDL_calloc(1, sizeof(*self));
+    Uint8                              i           = 0;
+    SDL_GPUColorTargetBlendState       blend_state = {
+        .src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+        .dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+        .color_blend_op        = SDL_GPU_BLENDOP_ADD,
+        .src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ZERO,
+        .dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+        .alpha_blend_op        = SDL_GPU_BLENDOP_ADD,
+        .enable_blend          = true
+    };
+    SDL_GPUGraphicsPipelineCreateInfo  info        = {
         .rasterizer_state.enable_depth_clip = true,
         .target_info                        = {
             .color_target_descriptions = &(SDL_GPUColorTargetDescription){
@@ -106,7 +230,7 @@ FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
         "shading.frag",
         SDL_GPU_SHADERSTAGE_FRAGMENT,
         SDL_arraysize(self->sampler_binds),
-        FG_LIGHT_VARIANTS,
+        FG_SHADING_SSBOS,
         1
     );
     if (!self->fragshdr) {
@@ -114,6 +238,65 @@ FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
         return NULL;
     }
 
+    self->volume_vertshdr = FG_LoadShader(
+        self->device, "volume.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 0, 0);
+    if (!self->volume_vertshdr) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    self->volume_fragshdr = FG_LoadShader(
+        self->device,
+        "shading_volume.frag",
+        SDL_GPU_SHADERSTAGE_FRAGMENT,
+        SDL_arraysize(self->sampler_binds),
+        FG_SHADING_SSBOS,
+        1
+    );
+    if (!self->volume_fragshdr) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    self->lowres_fragshdr = FG_LoadShader(
+        self->device,
+        "shading_lowres.frag",
+        SDL_GPU_SHADERSTAGE_FRAGMENT,
+        SDL_arraysize(self->sampler_binds),
+        FG_SHADING_SSBOS,
+        1
+    );
+    if (!self->lowres_fragshdr) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    self->lowres_volume_fragshdr = FG_LoadShader(
+        self->device,
+        "shading_volume_lowres.frag",
+        SDL_GPU_SHADERSTAGE_FRAGMENT,
+        SDL_arraysize(self->sampler_binds),
+        FG_SHADING_SSBOS,
+        1
+    );
+    if (!self->lowres_volume_fragshdr) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    self->upsample_fragshdr = FG_LoadShader(
+        self->device,
+        "shading_upsample.frag",
+        SDL_GPU_SHADERSTAGE_FRAGMENT,
+        SDL_arraysize(self->sampler_binds) + FG_LIGHT_TARGETS,
+        0,
+        1
+    );
+    if (!self->upsample_fragshdr) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
     for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
         self->sampler_binds[i].sampler = SDL_CreateGPUSampler(
             self->device,
@@ -129,7 +312,7 @@ FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
         }
     }
 
-    for (i = 0; i != FG_LIGHT_VARIANTS; ++i) {
+    for (i = 0; i != FG_SHADING_SSBOS; ++i) {
         self->ssbo_infos[i].usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ;
         self->ssbo_infos[i].size  = sizeof(Uint32);
 
@@ -138,15 +321,6 @@ FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
             FG_DestroyShadingStage(self);
             return NULL;
         }
-
-        self->transbufs[i] = SDL_CreateGPUTransferBuffer(
-            self->device,
-            &(SDL_GPUTransferBufferCreateInfo){ .size = self->ssbo_infos[i].size }
-        );
-        if (!self->transbufs[i]) {
-            FG_DestroyShadingStage(self);
-            return NULL;
-        }
     }
 
     info.vertex_shader   = self->vertshdr;
@@ -158,48 +332,251 @@ FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
         return NULL;
     }
 
+    info.fragment_shader = self->upsample_fragshdr;
+
+    self->upsample_pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+    if (!self->upsample_pipeline) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    /* reduced resolution cameras write diffuse and specular sums separately */
+    info.fragment_shader                       = self->lowres_fragshdr;
+    info.target_info.color_target_descriptions = (SDL_GPUColorTargetDescription[]){
+        { .format = FG_LIGHT_FORMAT }, { .format = FG_LIGHT_FORMAT }
+    };
+    info.target_info.num_color_targets         = FG_LIGHT_TARGETS;
+
+    self->lowres_pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+    if (!self->lowres_pipeline) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    self->vertbuf_info.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
+    self->vertbuf_info.size  = sizeof(FG_LightVolume);
+
+    self->vertbuf_bind.buffer = SDL_CreateGPUBuffer(self->device, &self->vertbuf_info);
+    if (!self->vertbuf_bind.buffer) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    /* volumes only add the omni lights on top of the full-screen pass */
+    info.vertex_shader      = self->volume_vertshdr;
+    info.fragment_shader    = self->lowres_volume_fragshdr;
+    info.vertex_input_state = (SDL_GPUVertexInputState){
+        .vertex_buffer_descriptions = &(SDL_GPUVertexBufferDescription){
+            .pitch      = sizeof(FG_LightVolume),
+            .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE
+        },
+        .num_vertex_buffers         = 1,
+        .vertex_attributes          = (SDL_GPUVertexAttribute[]){
+            {
+                .location = 0,
+                .format   = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+                .offset   = offsetof(FG_LightVolume, rect)
+            },
+            {
+                .location = 1,
+                .format   = SDL_GPU_VERTEXELEMENTFORMAT_UINT,
+                .offset   = offsetof(FG_LightVolume, light)
+            }
+        },
+        .num_vertex_attributes      = 2
+    };
+    info.target_info.color_target_descriptions = (SDL_GPUColorTargetDescription[]){
+        { .format = FG_LIGHT_FORMAT, .blend_state = blend_state },
+        { .format = FG_LIGHT_FORMAT, .blend_state = blend_state }
+    };
+
+    self->lowres_volume_pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+    if (!self->lowres_volume_pipeline) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
+    info.fragment_shader                       = self->volume_fragshdr;
+    info.target_info.color_target_descriptions = &(SDL_GPUColorTargetDescription){
+        .format      = targbuf_fmt,
+        .blend_state = blend_state
+    };
+    info.target_info.num_color_targets         = 1;
+
+    self->volume_pipeline = SDL_CreateGPUGraphicsPipeline(self->device, &info);
+    if (!self->volume_pipeline) {
+        FG_DestroyShadingStage(self);
+        return NULL;
+    }
+
     return self;
 }
 
-void FG_ShadingStageUpdate(FG_ShadingStage        *self,
-                           SDL_GPUColorTargetInfo *gbuftarg_infos)
+bool FG_ShadingStageUpdate(FG_ShadingStage        *self,
+                           Uint32                  width,
+                           Uint32                  height,
+                           SDL_GPUColorTargetInfo *gbuftarg_infos,
+                           SDL_GPUTexture         *depthtex)
 {
-    Uint8 i = 0;
+    Uint8                    i    = 0;
+    SDL_GPUTextureCreateInfo info = {
+        .format               = FG_LIGHT_FORMAT,
+        .usage                = SDL_GPU_TEXTUREUSAGE_SAMPLER
+                              | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+        .width                = (width + 1) / 2,
+        .height               = (height + 1) / 2,
+        .layer_count_or_depth = 1,
+        .num_levels           = 1
+    };
 
-    for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
-        self->sampler_binds[i].texture = gbuftarg_infos[i].texture;
+    /* position is rebuilt from depth, so depth takes the first binding */
+    self->sampler_binds[0].texture = depthtex;
+    for (i = 0; i != FG_GBUF_COUNT; ++i) {
+        self->sampler_binds[i + 1].texture = gbuftarg_infos[i].texture;
+    }
+
+    /* sized for half resolution, quarter resolution uses the top left of it */
+    for (i = 0; i != FG_LIGHT_TARGETS; ++i) {
+        SDL_ReleaseGPUTexture(self->device, self->lighttarg_infos[i].texture);
+        self->lighttarg_infos[i].texture = SDL_CreateGPUTexture(self->device, &info);
+        if (!self->lighttarg_infos[i].texture) return false;
+
+        self->lighttarg_infos[i].load_op  = SDL_GPU_LOADOP_DONT_CARE;
+        self->lighttarg_infos[i].store_op = SDL_GPU_STOREOP_STORE;
+        self->light_binds[i].texture      = self->lighttarg_infos[i].texture;
+        self->light_binds[i].sampler      = self->sampler_binds[0].sampler;
+    }
+
+    return true;
+}
+
+void FG_FilterDirectLights(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_LightJob    *job    = data;
+    const FG_DirectLight *direct = (const FG_DirectLight *)job->src + begin;
+    const FG_DirectLight *last   = (const FG_DirectLight *)job->src + end;
+    const void          **dst    = job->stage->lights + begin;
+    Uint32                count  = 0;
+
+    for (; direct != last; ++direct) {
+        if (direct->mask & job->stage->camera_mask &&
+            (direct->direction.x != 0.0F ||
+             direct->direction.y != 0.0F ||
+             direct->direction.z != 0.0F)) {
+            dst[count++] = direct;
+        }
+    }
+
+    job->stage->chunk_counts[chunk] = count;
+}
+
+void FG_FilterOmniLights(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_LightJob     *job     = data;
+    const FG_ShadingStage *stage   = job->stage;
+    const FG_OmniLight    *omnis   = (const FG_OmniLight *)job->src;
+    const void           **dst     = stage->lights + begin;
+    FG_OmniLight           tail[4] = { 0 };
+    const FG_OmniLight    *batch   = NULL;
+    Uint8                  visible = 0;
+    Uint32                 count   = 0;
+    Uint32                 i       = 0;
+    Uint32                 j       = 0;
+
+    /* a light survives if any camera both sees its mask and its sphere */
+    for (i = begin; i < end; i += 4) {
+        batch = omnis + i;
+        if (end - i < 4) {
+            SDL_memcpy(tail, batch, (end - i) * sizeof(*tail));
+            batch = tail;
+        }
+
+        visible = 0;
+        for (j = 0; j != stage->camera_count && visible != 0xF; ++j) {
+            if (stage->cameras[j]->unlit) continue;
+
+            visible |= FG_CullOmniLights4(
+                batch, stage->frustums + j, stage->cameras[j]->mask);
+        }
+
+        for (j = 0; visible; ++j, visible >>= 1) {
+            if (visible & 1) dst[count++] = omnis + i + j;
+        }
+    }
+
+    job->stage->chunk_counts[chunk] = count;
+}
+
+void FG_PackDirectLights(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
+{
+    const FG_LightJob *job    = data;
+    FG_DirectLight     direct = { 0 };
+    float              length = 0.0F;
+    Uint32             i      = 0;
+
+    (void)chunk;
+
+    /* normalized once here rather than for every shaded pixel */
+    for (i = begin; i != end; ++i) {
+        direct = *(const FG_DirectLight *)job->stage->lights[i];
+        length = SDL_sqrtf(direct.direction.x * direct.direction.x
+                         + direct.direction.y * direct.direction.y
+                         + direct.direction.z * direct.direction.z);
+
+        direct.direction.x /= length;
+        direct.direction.y /= length;
+        direct.direction.z /= length;
+
+        SDL_memcpy(job->transmem + i * sizeof(direct), &direct, sizeof(direct));
     }
 }
 
-bool FG_AmbientLightFilter(Uint32 mask, const void *light)
+void FG_PackOmniLights(void *data, Uint32 chunk, Uint32 begin, Uint32 end)
 {
-    return ((const FG_DirectLight *)light)->mask & mask &&
-           (((const FG_DirectLight *)light)->direction.x != 0.0F ||
-           ((const FG_DirectLight *)light)->direction.y != 0.0F ||
-           ((const FG_DirectLight *)light)->direction.z != 0.0F);
+    const FG_LightJob *job = data;
+    Uint32             i   = 0;
+
+    (void)chunk;
+
+    for (i = begin; i != end; ++i) {
+        SDL_memcpy(job->transmem + i * sizeof(FG_OmniLight),
+                   job->stage->lights[i],
+                   sizeof(FG_OmniLight));
+    }
 }
 
-bool FG_OmniLightFilter(Uint32 mask, const void *light)
+void * FG_ShadingStageReserve(FG_ShadingStage         *self,
+                              FG_Staging              *staging,
+                              SDL_GPUBufferCreateInfo *info,
+                              SDL_GPUBuffer          **buffer,
+                              Uint32                   size)
 {
-    return ((const FG_OmniLight *)light)->mask & mask &&
-           0.0F < ((const FG_OmniLight *)light)->radius;
+    if (info->size < size) {
+        info->size = SDL_max(2 * info->size, size);
+
+        SDL_ReleaseGPUBuffer(self->device, *buffer);
+        *buffer = SDL_CreateGPUBuffer(self->device, info);
+        if (!*buffer) return NULL;
+    }
+
+    return FG_StagingUploadToBuffer(staging, *buffer, 0, size);
 }
 
 bool FG_ShadingStageSubCopy(FG_ShadingStage *self,
-                            SDL_GPUCopyPass *cpypass,
+                            FG_Staging      *staging,
+                            FG_Jobs         *jobs,
                             Uint8            dst,
                             Uint32          *dst_size,
                             const void      *src,
                             Uint32           src_count,
                             Uint8            size,
-                            Uint32           mask,
-                            FG_LightFilter   filter)
+                            FG_JobFunction   filter,
+                            FG_JobFunction   pack)
 {
-    const Uint8 *it       = src;
-    const void  *end      = it + src_count * size;
-    Uint32       count    = 0;
-    Uint8       *transmem = NULL;
-    Uint32       i        = 0;
+    Uint32      chunk_count = FG_GetJobChunkCount(src_count, FG_LIGHT_GRAIN);
+    FG_LightJob job         = { .stage = self, .src = src };
+    Uint32      count       = 0;
+    Uint32      i           = 0;
 
     if (self->capacity < src_count) {
         self->capacity = src_count;
@@ -207,88 +584,352 @@ bool FG_ShadingStageSubCopy(FG_ShadingStage *self,
         self->lights = SDL_realloc(
             self->lights, self->capacity * sizeof(*self->lights));
         if (!self->lights) return false;
+
+        self->chunk_counts = SDL_realloc(
+            self->chunk_counts, chunk_count * sizeof(*self->chunk_counts));
+        if (!self->chunk_counts) return false;
+
+        self->rects = SDL_realloc(self->rects, self->capacity * sizeof(*self->rects));
+        if (!self->rects) return false;
     }
 
-    for (it = src, count = 0; it != end; it += size) {
-        if (filter(mask, it)) self->lights[count++] = it;
+    FG_JobsParallelFor(jobs, src_count, FG_LIGHT_GRAIN, filter, &job);
+
+    /* compact in chunk order so the light order never depends on scheduling */
+    for (i = 0; i != chunk_count; ++i) {
+        SDL_memmove(self->lights + count,
+                    self->lights + i * FG_LIGHT_GRAIN,
+                    self->chunk_counts[i] * sizeof(*self->lights));
+
+        count += self->chunk_counts[i];
     }
 
+    *dst_size = count * size;
+
     if (!count) return true;
 
-    *dst_size = count * size;
+    job.transmem = FG_ShadingStageReserve(
+        self, staging, self->ssbo_infos + dst, self->ssbos + dst, *dst_size);
+    if (!job.transmem) return false;
 
-    if (self->ssbo_infos[dst].size < *dst_size) {
-        self->ssbo_infos[dst].size = *dst_size;
+    FG_JobsParallelFor(jobs, count, FG_LIGHT_GRAIN, pack, &job);
 
-        SDL_ReleaseGPUBuffer(self->device, self->ssbos[dst]);
-        self->ssbos[dst] = SDL_CreateGPUBuffer(self->device, self->ssbo_infos + dst);
-        if (!self->ssbos[dst]) return false;
+    return true;
+}
 
-        SDL_ReleaseGPUTransferBuffer(self->device, self->transbufs[dst]);
-        self->transbufs[dst] = SDL_CreateGPUTransferBuffer(
-            self->device,
-            &(SDL_GPUTransferBufferCreateInfo){ .size = self->ssbo_infos[dst].size }
-        );
-        if (!self->transbufs[dst]) return false;
+bool FG_GetLightBounds(const FG_OmniLight *omni,
+                       const FG_Camera    *camera,
+                       const FG_Mat4      *vpmat,
+                       FG_AABB            *bounds)
+{
+    if (!(omni->mask & camera->mask)) return false;
+
+    if (!FG_ProjectSphere(vpmat, &omni->transl, omni->radius, bounds)) {
+        *bounds = (FG_AABB){ .br = { .x = 1.0F, .y = 1.0F } };
     }
 
-    transmem = SDL_MapGPUTransferBuffer(self->device, self->transbufs[dst], true);
-    if (!transmem) return false;
+    if (bounds->br.x < 0.0F || 1.0F < bounds->tl.x ||
+        bounds->br.y < 0.0F || 1.0F < bounds->tl.y) {
+        return false;
+    }
+
+    bounds->tl.x = SDL_max(bounds->tl.x, 0.0F);
+    bounds->tl.y = SDL_max(bounds->tl.y, 0.0F);
+    bounds->br.x = SDL_min(bounds->br.x, 1.0F);
+    bounds->br.y = SDL_min(bounds->br.y, 1.0F);
+
+    return true;
+}
+
+bool FG_ShadingStageBin(FG_ShadingStage       *self,
+                        FG_Staging            *staging,
+                        Uint32                 camera_count,
+                        const FG_Camera      **cameras,
+                        const SDL_GPUViewport *viewports,
+                        const FG_Mat4         *vpmats)
+{
+    Uint32        omni_count  = self->omnis_size / sizeof(FG_OmniLight);
+    Uint32        tile_count  = 0;
+    Uint32        index_count = 0;
+    Uint32        i           = 0;
+    Uint32        j           = 0;
+    Uint32        x           = 0;
+    Uint32        y           = 0;
+    FG_LightGrid *grid        = NULL;
+    FG_AABB       bounds      = { 0 };
+    FG_TileRect  *rect        = NULL;
+    FG_LightTile *tile        = NULL;
+    Uint32        capacity    = 0;
+    void         *transmem    = NULL;
+
+    for (i = 0; i != camera_count; ++i) {
+        if (cameras[i]->unlit) continue;
+
+        grid            = self->grids + i;
+        grid->origin[0] = (Uint32)viewports[i].x;
+        grid->origin[1] = (Uint32)viewports[i].y;
+        grid->count[0]  = (Uint32)SDL_ceilf(viewports[i].w / FG_LIGHT_TILE_SIZE);
+        grid->count[1]  = (Uint32)SDL_ceilf(viewports[i].h / FG_LIGHT_TILE_SIZE);
+        grid->offset    = tile_count;
+
+        tile_count += grid->count[0] * grid->count[1];
+
+        if (self->tile_capacity < tile_count) {
+            capacity = SDL_max(2 * self->tile_capacity, tile_count);
+
+            tile = SDL_realloc(self->tiles, capacity * sizeof(*self->tiles));
+            if (!tile) return false;
+
+            self->tiles         = tile;
+            self->tile_capacity = capacity;
+        }
 
-    for (i = 0; i != count; ++i, transmem += size) {
-        SDL_memcpy(transmem, self->lights[i], size);
+        SDL_memset(self->tiles + grid->offset,
+                   0,
+                   (tile_count - grid->offset) * sizeof(*self->tiles));
+
+        for (j = 0; j != omni_count; ++j) {
+            rect = self->rects + j;
+
+            SDL_memset(rect, 0, sizeof(*rect));
+
+            if (!FG_GetLightBounds(self->lights[j], cameras[i], vpmats + i, &bounds)) {
+                continue;
+            }
+
+            /* widen by a pixel to cover the truncated viewport origin */
+            rect->left   = (Uint32)SDL_max(
+                bounds.tl.x * viewports[i].w - 1.0F, 0.0F) / FG_LIGHT_TILE_SIZE;
+            rect->top    = (Uint32)SDL_max(
+                bounds.tl.y * viewports[i].h - 1.0F, 0.0F) / FG_LIGHT_TILE_SIZE;
+            rect->right  = SDL_min(
+                (Uint32)SDL_min(bounds.br.x * viewports[i].w + 1.0F, viewports[i].w)
+                / FG_LIGHT_TILE_SIZE + 1,
+                grid->count[0]
+            );
+            rect->bottom = SDL_min(
+                (Uint32)SDL_min(bounds.br.y * viewports[i].h + 1.0F, viewports[i].h)
+                / FG_LIGHT_TILE_SIZE + 1,
+                grid->count[1]
+            );
+
+            for (y = rect->top; y < rect->bottom; ++y) {
+                for (x = rect->left; x < rect->right; ++x) {
+                    ++self->tiles[grid->offset + y * grid->count[0] + x].count;
+                }
+            }
+        }
+
+        for (tile = self->tiles + grid->offset;
+             tile != self->tiles + tile_count;
+             ++tile) {
+            tile->offset  = index_count;
+            index_count  += tile->count;
+            tile->count   = 0;
+        }
+
+        if (self->index_capacity < index_count) {
+            capacity = SDL_max(2 * self->index_capacity, index_count);
+
+            transmem = SDL_realloc(self->indices, capacity * sizeof(*self->indices));
+            if (!transmem) return false;
+
+            self->indices        = transmem;
+            self->index_capacity = capacity;
+        }
+
+        for (j = 0; j != omni_count; ++j) {
+            rect = self->rects + j;
+
+            for (y = rect->top; y < rect->bottom; ++y) {
+                for (x = rect->left; x < rect->right; ++x) {
+                    tile = self->tiles + grid->offset + y * grid->count[0] + x;
+                    self->indices[tile->offset + tile->count++] = j;
+                }
+            }
+        }
     }
 
-    SDL_UnmapGPUTransferBuffer(self->device, self->transbufs[dst]);
+    if (tile_count) {
+        transmem = FG_ShadingStageReserve(self,
+                                          staging,
+                                          self->ssbo_infos + FG_LIGHT_VARIANTS,
+                                          self->ssbos + FG_LIGHT_VARIANTS,
+                                          tile_count * sizeof(*self->tiles));
+        if (!transmem) return false;
 
-    SDL_UploadToGPUBuffer(
-        cpypass,
-        &(SDL_GPUTransferBufferLocation){ .transfer_buffer = self->transbufs[dst] },
-        &(SDL_GPUBufferRegion){
-            .buffer = self->ssbos[dst],
-            .size   = self->ssbo_infos[dst].size
-        },
-        false
-    );
+        SDL_memcpy(transmem, self->tiles, tile_count * sizeof(*self->tiles));
+    }
+
+    if (index_count) {
+        transmem = FG_ShadingStageReserve(self,
+                                          staging,
+                                          self->ssbo_infos + FG_LIGHT_VARIANTS + 1,
+                                          self->ssbos + FG_LIGHT_VARIANTS + 1,
+                                          index_count * sizeof(*self->indices));
+        if (!transmem) return false;
+
+        SDL_memcpy(transmem, self->indices, index_count * sizeof(*self->indices));
+    }
+
+    return true;
+}
+
+bool FG_ShadingStageCullVolumes(FG_ShadingStage  *self,
+                                FG_Staging       *staging,
+                                Uint32            camera_count,
+                                const FG_Camera **cameras,
+                                const FG_Mat4    *vpmats)
+{
+    Uint32          omni_count = self->omnis_size / sizeof(FG_OmniLight);
+    Uint32          count      = 0;
+    Uint32          i          = 0;
+    Uint32          j          = 0;
+    FG_AABB         bounds     = { 0 };
+    Uint32          capacity   = 0;
+    FG_LightVolume *volumes    = NULL;
+    void           *transmem   = NULL;
+
+    for (i = 0; i != camera_count; ++i) {
+        self->volume_offsets[i] = count;
+
+        if (cameras[i]->unlit) continue;
+
+        if (self->volume_capacity < count + omni_count) {
+            capacity = SDL_max(2 * self->volume_capacity, count + omni_count);
+
+            volumes = SDL_realloc(self->volumes, capacity * sizeof(*volumes));
+            if (!volumes) return false;
+
+            self->volumes         = volumes;
+            self->volume_capacity = capacity;
+        }
+
+        for (j = 0; j != omni_count; ++j) {
+            if (!FG_GetLightBounds(self->lights[j], cameras[i], vpmats + i, &bounds)) {
+                continue;
+            }
+
+            /* viewport units to normalized device coordinates */
+            self->volumes[count].rect.tl.x = 2.0F * bounds.tl.x - 1.0F;
+            self->volumes[count].rect.tl.y = 1.0F - 2.0F * bounds.br.y;
+            self->volumes[count].rect.br.x = 2.0F * bounds.br.x - 1.0F;
+            self->volumes[count].rect.br.y = 1.0F - 2.0F * bounds.tl.y;
+            self->volumes[count].light     = j;
+            ++count;
+        }
+    }
+
+    self->volume_offsets[camera_count] = count;
+
+    if (!count) return true;
+
+    transmem = FG_ShadingStageReserve(self,
+                                      staging,
+                                      &self->vertbuf_info,
+                                      &self->vertbuf_bind.buffer,
+                                      count * sizeof(*self->volumes));
+    if (!transmem) return false;
+
+    SDL_memcpy(transmem, self->volumes, count * sizeof(*self->volumes));
 
     return true;
 }
 
 bool FG_ShadingStageCopy(FG_ShadingStage               *self,
-                         SDL_GPUCopyPass               *cpypass,
-                         Uint32                         mask,
+                         FG_Staging                    *staging,
+                         FG_Jobs                       *jobs,
+                         Uint32                         camera_count,
+                         const FG_Camera              **cameras,
+                         const SDL_GPUViewport         *viewports,
+                         const FG_Mat4                 *vpmats,
                          const FG_ShadingStageDrawInfo *info)
 {
+    Uint32 i = 0;
+
+    if (self->camera_capacity < camera_count + 1) {
+        self->grids = SDL_realloc(
+            self->grids, (camera_count + 1) * sizeof(*self->grids));
+        if (!self->grids) return false;
+
+        self->volume_offsets = SDL_realloc(
+            self->volume_offsets, (camera_count + 1) * sizeof(*self->volume_offsets));
+        if (!self->volume_offsets) return false;
+
+        self->frustums = SDL_realloc(
+            self->frustums, (camera_count + 1) * sizeof(*self->frustums));
+        if (!self->frustums) return false;
+
+        self->camera_capacity = camera_count + 1;
+    }
+
+    self->camera_count = camera_count;
+    self->camera_mask  = 0;
+    self->cameras      = cameras;
+    for (i = 0; i != camera_count; ++i) {
+        FG_SetFrustum(vpmats + i, self->frustums + i);
+        if (!cameras[i]->unlit) self->camera_mask |= cameras[i]->mask;
+    }
+
+    SDL_memset(self->grids, 0, camera_count * sizeof(*self->grids));
+    SDL_memset(
+        self->volume_offsets, 0, (camera_count + 1) * sizeof(*self->volume_offsets));
+
+    /* the omni lights go last, binning reads them back from the filtered list */
     return FG_ShadingStageSubCopy(
                self,
-               cpypass,
+               staging,
+               jobs,
                0,
                &self->ubo.directs_size,
                info->directs,
                info->direct_count,
                sizeof(*info->directs),
-               mask,
-               FG_AmbientLightFilter
+               FG_FilterDirectLights,
+               FG_PackDirectLights
            ) &&
            FG_ShadingStageSubCopy(
                self,
-               cpypass,
+               staging,
+               jobs,
                1,
-               &self->ubo.omnis_size,
+               &self->omnis_size,
                info->omnis,
                info->omni_count,
                sizeof(*info->omnis),
-               mask,
-               FG_OmniLightFilter
-           );
+               FG_FilterOmniLights,
+               FG_PackOmniLights
+           ) &&
+           (self->lighting == FG_LIGHTING_VOLUMES ?
+               FG_ShadingStageCullVolumes(
+                   self, staging, camera_count, cameras, vpmats) :
+               FG_ShadingStageBin(
+                   self, staging, camera_count, cameras, viewports, vpmats));
+}
+
+void FG_ShadingStageSetLighting(FG_ShadingStage *self, FG_Lighting lighting)
+{
+    self->lighting = lighting;
 }
 
-void FG_ShadingStageDraw(FG_ShadingStage      *self,
-                         SDL_GPUCommandBuffer *cmdbuf,
-                         SDL_GPURenderPass    *rndrpass,
-                         const FG_Camera      *camera)
+bool FG_ShadingStageSetUniforms(FG_ShadingStage       *self,
+                                Uint32                 index,
+                                const SDL_GPUViewport *viewport,
+                                const FG_Mat4         *vpmat,
+                                const FG_Camera       *camera)
 {
+    /* a degenerate camera has no positions to reconstruct, so it is not lit */
+    if (!FG_InvertMat4(vpmat, &self->ubo.invvp)) return false;
+
+    self->ubo.viewport[0] = viewport->x;
+    self->ubo.viewport[1] = viewport->y;
+    self->ubo.viewport[2] = viewport->w;
+    self->ubo.viewport[3] = viewport->h;
+
     self->ubo.origo = camera->transf.transl;
+    self->ubo.mask  = camera->mask;
+    self->ubo.grid  = self->grids[index];
+    self->ubo.scale = (float)(1 << camera->shading);
     if (camera->env) {
         self->ubo.ambient = camera->env->light;
         self->ubo.shine   = camera->env->shine;
@@ -298,12 +939,118 @@ void FG_ShadingStageDraw(FG_ShadingStage      *self,
         self->ubo.shine   = 32.0F;
     }
 
+    return true;
+}
+
+bool FG_ShadingStageBindLights(FG_ShadingStage       *self,
+                               SDL_GPUCommandBuffer  *cmdbuf,
+                               SDL_GPURenderPass     *rndrpass,
+                               Uint32                 index,
+                               const SDL_GPUViewport *viewport,
+                               const FG_Mat4         *vpmat,
+                               const FG_Camera       *camera)
+{
+    if (!FG_ShadingStageSetUniforms(self, index, viewport, vpmat, camera)) {
+        return false;
+    }
+
+    /* forward shaded fragments are always at full resolution */
+    self->ubo.scale = 1.0F;
+
+    SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_SHADING_SSBOS);
+    SDL_PushGPUFragmentUniformData(cmdbuf, 0, &self->ubo, sizeof(self->ubo));
+
+    return true;
+}
+
+void FG_ShadingStageDrawLights(FG_ShadingStage       *self,
+                               SDL_GPUCommandBuffer  *cmdbuf,
+                               Uint32                 index,
+                               const SDL_GPUViewport *viewport,
+                               const FG_Mat4         *vpmat,
+                               const FG_Camera       *camera)
+{
+    Uint32             offset   = self->volume_offsets[index];
+    Uint32             count    = self->volume_offsets[index + 1] - offset;
+    SDL_GPURenderPass *rndrpass = NULL;
+
+    if (camera->shading == FG_SHADING_FULL) return;
+
+    if (!FG_ShadingStageSetUniforms(self, index, viewport, vpmat, camera)) return;
+
+    rndrpass = SDL_BeginGPURenderPass(
+        cmdbuf, self->lighttarg_infos, FG_LIGHT_TARGETS, NULL);
+    SDL_SetGPUViewport(
+        rndrpass,
+        &(SDL_GPUViewport){
+            .x         = viewport->x / self->ubo.scale,
+            .y         = viewport->y / self->ubo.scale,
+            .w         = viewport->w / self->ubo.scale,
+            .h         = viewport->h / self->ubo.scale,
+            .max_depth = 1.0F
+        }
+    );
+    SDL_BindGPUFragmentSamplers(
+        rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
+    SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_SHADING_SSBOS);
+    SDL_PushGPUFragmentUniformData(cmdbuf, 0, &self->ubo, sizeof(self->ubo));
+    SDL_BindGPUGraphicsPipeline(rndrpass, self->lowres_pipeline);
+    SDL_DrawGPUPrimitives(rndrpass, 3, 1, 0, 0);
+
+    if (count) {
+        SDL_BindGPUGraphicsPipeline(rndrpass, self->lowres_volume_pipeline);
+        SDL_BindGPUVertexBuffers(rndrpass, 0, &self->vertbuf_bind, 1);
+        SDL_BindGPUFragmentSamplers(
+            rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
+        SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_SHADING_SSBOS);
+        SDL_DrawGPUPrimitives(rndrpass, 6, count, 0, offset);
+    }
+
+    SDL_EndGPURenderPass(rndrpass);
+}
+
+void FG_ShadingStageDraw(FG_ShadingStage       *self,
+                         SDL_GPUCommandBuffer  *cmdbuf,
+                         SDL_GPURenderPass     *rndrpass,
+                         Uint32                 index,
+                         const SDL_GPUViewport *viewport,
+                         const FG_Mat4         *vpmat,
+                         const FG_Camera       *camera)
+{
+    Uint32 offset = self->volume_offsets[index];
+    Uint32 count  = self->volume_offsets[index + 1] - offset;
+
+    if (!FG_ShadingStageSetUniforms(self, index, viewport, vpmat, camera)) return;
+
+    /* the lighting was already summed at a lower resolution, only resolve it */
+    if (camera->shading != FG_SHADING_FULL) {
+        SDL_BindGPUFragmentSamplers(
+            rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
+        SDL_BindGPUFragmentSamplers(rndrpass,
+                                    SDL_arraysize(self->sampler_binds),
+                                    self->light_binds,
+                                    FG_LIGHT_TARGETS);
+        SDL_PushGPUFragmentUniformData(cmdbuf, 0, &self->ubo, sizeof(self->ubo));
+        SDL_BindGPUGraphicsPipeline(rndrpass, self->upsample_pipeline);
+        SDL_DrawGPUPrimitives(rndrpass, 3, 1, 0, 0);
+        return;
+    }
+
     SDL_BindGPUFragmentSamplers(
         rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
-    SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_LIGHT_VARIANTS);
+    SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_SHADING_SSBOS);
     SDL_PushGPUFragmentUniformData(cmdbuf, 0, &self->ubo, sizeof(self->ubo));
     SDL_BindGPUGraphicsPipeline(rndrpass, self->pipeline);
     SDL_DrawGPUPrimitives(rndrpass, 3, 1, 0, 0);
+
+    if (!count) return;
+
+    SDL_BindGPUGraphicsPipeline(rndrpass, self->volume_pipeline);
+    SDL_BindGPUVertexBuffers(rndrpass, 0, &self->vertbuf_bind, 1);
+    SDL_BindGPUFragmentSamplers(
+        rndrpass, 0, self->sampler_binds, SDL_arraysize(self->sampler_binds));
+    SDL_BindGPUFragmentStorageBuffers(rndrpass, 0, self->ssbos, FG_SHADING_SSBOS);
+    SDL_DrawGPUPrimitives(rndrpass, 6, count, 0, offset);
 }
 
 void FG_DestroyShadingStage(FG_ShadingStage *self)
@@ -311,15 +1058,35 @@ void FG_DestroyShadingStage(FG_ShadingStage *self)
     Uint8 i = 0;
 
     if (!self) return;
+    SDL_ReleaseGPUGraphicsPipeline(self->device, self->upsample_pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(self->device, self->lowres_volume_pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(self->device, self->lowres_pipeline);
+    SDL_ReleaseGPUGraphicsPipeline(self->device, self->volume_pipeline);
     SDL_ReleaseGPUGraphicsPipeline(self->device, self->pipeline);
-    for (i = 0; i != FG_LIGHT_VARIANTS; ++i) {
-        SDL_ReleaseGPUTransferBuffer(self->device, self->transbufs[i]);
+    SDL_ReleaseGPUBuffer(self->device, self->vertbuf_bind.buffer);
+    for (i = 0; i != FG_SHADING_SSBOS; ++i) {
         SDL_ReleaseGPUBuffer(self->device, self->ssbos[i]);
     }
+    SDL_free(self->volumes);
+    SDL_free(self->volume_offsets);
+    SDL_free(self->indices);
+    SDL_free(self->tiles);
+    SDL_free(self->frustums);
+    SDL_free(self->grids);
+    SDL_free(self->rects);
+    SDL_free(self->chunk_counts);
     SDL_free(self->lights);
+    for (i = 0; i != FG_LIGHT_TARGETS; ++i) {
+        SDL_ReleaseGPUTexture(self->device, self->lighttarg_infos[i].texture);
+    }
     for (i = 0; i != SDL_arraysize(self->sampler_binds); ++i) {
         SDL_ReleaseGPUSampler(self->device, self->sampler_binds[i].sampler);
     }
+    SDL_ReleaseGPUShader(self->device, self->upsample_fragshdr);
+    SDL_ReleaseGPUShader(self->device, self->lowres_volume_fragshdr);
+    SDL_ReleaseGPUShader(self->device, self->lowres_fragshdr);
+    SDL_ReleaseGPUShader(self->device, self->volume_fragshdr);
+    SDL_ReleaseGPUShader(self->device, self->volume_vertshdr);
     SDL_ReleaseGPUShader(self->device, self->fragshdr);
     SDL_ReleaseGPUShader(self->device, self->vertshdr);
     SDL_free(self);
@@ -25,29 +25,62 @@
 #define FLYGPU_SHADING_STAGE_H
 
 #include "../include/flygpu/flygpu.h"
+#include "jobs.h"
+#include "linalg.h"
+#include "staging.h"
 
 #include <SDL3/SDL_gpu.h>
 #include <SDL3/SDL_stdinc.h>
 
 #include <stdbool.h>
 
+#define FG_LIGHT_VARIANTS 2
+#define FG_SHADING_SSBOS  (FG_LIGHT_VARIANTS + 2)
+
 typedef struct FG_ShadingStage FG_ShadingStage;
 
 FG_ShadingStage * FG_CreateShadingStage(SDL_GPUDevice        *device,
                                         SDL_GPUTextureFormat  targbuf_fmt);
 
-void FG_ShadingStageUpdate(FG_ShadingStage        *self,
-                           SDL_GPUColorTargetInfo *gbuftarg_infos);
+bool FG_ShadingStageUpdate(FG_ShadingStage        *self,
+                           Uint32                  width,
+                           Uint32                  height,
+                           SDL_GPUColorTargetInfo *gbuftarg_infos,
+                           SDL_GPUTexture         *depthtex);
 
 bool FG_ShadingStageCopy(FG_ShadingStage               *self,
-                         SDL_GPUCopyPass               *cpypass,
-                         Uint32                         mask,
+                         FG_Staging                    *staging,
+                         FG_Jobs                       *jobs,
+                         Uint32                         camera_count,
+                         const FG_Camera              **cameras,
+                         const SDL_GPUViewport         *viewports,
+                         const FG_Mat4                 *vpmats,
                          const FG_ShadingStageDrawInfo *info);
 
-void FG_ShadingStageDraw(FG_ShadingStage      *self,
-                         SDL_GPUCommandBuffer *cmdbuf,
-                         SDL_GPURenderPass    *rndrpass,
-                         const FG_Camera      *camera);
+void FG_ShadingStageSetLighting(FG_ShadingStage *self, FG_Lighting lighting);
+
+bool FG_ShadingStageBindLights(FG_ShadingStage       *self,
+                               SDL_GPUCommandBuffer  *cmdbuf,
+                               SDL_GPURenderPass     *rndrpass,
+                               Uint32                 index,
+                               const SDL_GPUViewport *viewport,
+                               const FG_Mat4         *vpmat,
+                               const FG_Camera       *camera);
+
+void FG_ShadingStageDrawLights(FG_ShadingStage       *self,
+                               SDL_GPUCommandBuffer  *cmdbuf,
+                               Uint32                 index,
+                               const SDL_GPUViewport *viewport,
+                               const FG_Mat4         *vpmat,
+                               const FG_Camera       *camera);
+
+void FG_ShadingStageDraw(FG_ShadingStage       *self,
+                         SDL_GPUCommandBuffer  *cmdbuf,
+                         SDL_GPURenderPass     *rndrpass,
+                         Uint32                 index,
+                         const SDL_GPUViewport *viewport,
+                         const FG_Mat4         *vpmat,
+                         const FG_Camera       *camera);
 
 void FG_DestroyShadingStage(FG_ShadingStage *self);
 
@@ -0,0 +1,337 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "staging.h"
+
+#include "config.h"
+
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FG_STAGING_ALIGNMENT 16
+#define FG_STAGING_CAPACITY  65536
+
+typedef struct
+{
+    SDL_GPUTransferBuffer *transbuf;
+    SDL_GPUFence          *fence;
+    Uint64                 token;
+    Uint32                 capacity;
+    Uint32                 padding;
+} FG_StagingFrame;
+
+typedef struct
+{
+    SDL_GPUTransferBufferLocation src;
+    SDL_GPUBufferRegion           dst;
+} FG_BufferUpload;
+
+typedef struct
+{
+    SDL_GPUTextureTransferInfo src;
+    SDL_GPUTextureRegion       dst;
+} FG_TextureUpload;
+
+struct FG_Staging
+{
+    SDL_GPUDevice          *device;
+    FG_StagingFrame         frames[FG_FRAMES_IN_FLIGHT];
+    Uint32                  frame;
+    Uint32                  size;
+    Uint64                  token;
+    Uint8                  *transmem;
+    Uint32                  buffer_capacity;
+    Uint32                  buffer_count;
+    FG_BufferUpload        *buffer_uploads;
+    Uint32                  texture_capacity;
+    Uint32                  texture_count;
+    FG_TextureUpload       *texture_uploads;
+    Uint32                  retiree_capacity;
+    Uint32                  retiree_count;
+    SDL_GPUTransferBuffer **retirees;
+};
+
+static void FG_StagingReset(FG_Staging *self);
+
+static Uint8 * FG_StagingAlloc(FG_Staging *self, Uint32 size, Uint32 *offset);
+
+FG_Staging * FG_CreateStaging(SDL_GPUDevice *device)
+{
+    FG_Staging *self = SDL_calloc(1, sizeof(*self));
+
+    if (!self) return NULL;
+
+    self->device = device;
+
+    return self;
+}
+
+void FG_StagingReset(FG_Staging *self)
+{
+    Uint32 i = 0;
+
+    if (self->transmem) {
+        SDL_UnmapGPUTransferBuffer(self->device, self->frames[self->frame].transbuf);
+        self->transmem = NULL;
+    }
+
+    for (i = 0; i != self->retiree_count; ++i) {
+        SDL_ReleaseGPUTransferBuffer(self->device, self->retirees[i]);
+    }
+
+    self->buffer_count  = 0;
+    self->texture_count = 0;
+    self->retiree_count = 0;
+}
+
+bool FG_StagingBegin(FG_Staging *self)
+{
+    FG_StagingFrame *frame = NULL;
+
+    FG_StagingReset(self);
+
+    self->frame = (self->frame + 1) % FG_FRAMES_IN_FLIGHT;
+    self->size  = 0;
+    frame       = self->frames + self->frame;
+
+    if (frame->fence) {
+        if (!SDL_WaitForGPUFences(self->device, true, &frame->fence, 1)) return false;
+        SDL_ReleaseGPUFence(self->device, frame->fence);
+        frame->fence = NULL;
+    }
+
+    return true;
+}
+
+Uint8 * FG_StagingAlloc(FG_Staging *self, Uint32 size, Uint32 *offset)
+{
+    FG_StagingFrame        *frame    = self->frames + self->frame;
+    Uint32                  capacity = 0;
+    SDL_GPUTransferBuffer **retirees = NULL;
+
+    *offset = (self->size + FG_STAGING_ALIGNMENT - 1)
+            & ~(Uint32)(FG_STAGING_ALIGNMENT - 1);
+
+    if (frame->capacity < *offset + size) {
+        if (self->transmem) {
+            SDL_UnmapGPUTransferBuffer(self->device, frame->transbuf);
+            self->transmem = NULL;
+        }
+
+        /* recorded uploads still read from the old buffer until the flush */
+        if (self->size) {
+            if (self->retiree_capacity == self->retiree_count) {
+                capacity = self->retiree_capacity ? 2 * self->retiree_capacity : 4;
+
+                retirees = SDL_realloc(self->retirees, capacity * sizeof(*retirees));
+                if (!retirees) return NULL;
+
+                self->retirees         = retirees;
+                self->retiree_capacity = capacity;
+            }
+
+            self->retirees[self->retiree_count++] = frame->transbuf;
+        }
+        else {
+            SDL_ReleaseGPUTransferBuffer(self->device, frame->transbuf);
+        }
+
+        capacity = frame->capacity ? 2 * frame->capacity : FG_STAGING_CAPACITY;
+        while (capacity < size) capacity *= 2;
+
+        frame->capacity = 0;
+        frame->transbuf = SDL_CreateGPUTransferBuffer(
+            self->device,
+            &(SDL_GPUTransferBufferCreateInfo){
+                .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+                .size  = capacity
+            }
+        );
+        if (!frame->transbuf) return NULL;
+
+        frame->capacity = capacity;
+        self->size      = 0;
+        *offset         = 0;
+    }
+
+    if (!self->transmem) {
+        self->transmem = SDL_MapGPUTransferBuffer(
+            self->device, frame->transbuf, false);
+        if (!self->transmem) return NULL;
+    }
+
+    self->size = *offset + size;
+
+    return self->transmem + *offset;
+}
+
+void * FG_StagingUploadToBuffer(FG_Staging    *self,
+                                SDL_GPUBuffer *buffer,
+                                Uint32         offset,
+                                Uint32         size)
+{
+    Uint32           src_offset = 0;
+    Uint8           *transmem   = FG_StagingAlloc(self, size, &src_offset);
+    Uint32           capacity   = 0;
+    FG_BufferUpload *uploads    = NULL;
+
+    if (!transmem) return NULL;
+
+    if (self->buffer_capacity == self->buffer_count) {
+        capacity = self->buffer_capacity ? 2 * self->buffer_capacity : 16;
+
+        uploads = SDL_realloc(self->buffer_uploads, capacity * sizeof(*uploads));
+        if (!uploads) return NULL;
+
+        self->buffer_uploads  = uploads;
+        self->buffer_capacity = capacity;
+    }
+
+    self->buffer_uploads[self->buffer_count++] = (FG_BufferUpload){
+        .src = {
+            .transfer_buffer = self->frames[self->frame].transbuf,
+            .offset          = src_offset
+        },
+        .dst = {
+            .buffer = buffer,
+            .offset = offset,
+            .size   = size
+        }
+    };
+
+    return transmem;
+}
+
+void * FG_StagingUploadToTexture(FG_Staging                 *self,
+                                 const SDL_GPUTextureRegion *region,
+                                 Uint32                      size)
+{
+    Uint32            src_offset = 0;
+    Uint8            *transmem   = FG_StagingAlloc(self, size, &src_offset);
+    Uint32            capacity   = 0;
+    FG_TextureUpload *uploads    = NULL;
+
+    if (!transmem) return NULL;
+
+    if (self->texture_capacity == self->texture_count) {
+        capacity = self->texture_capacity ? 2 * self->texture_capacity : 16;
+
+        uploads = SDL_realloc(self->texture_uploads, capacity * sizeof(*uploads));
+        if (!uploads) return NULL;
+
+        self->texture_uploads  = uploads;
+        self->texture_capacity = capacity;
+    }
+
+    self->texture_uploads[self->texture_count++] = (FG_TextureUpload){
+        .src = {
+            .transfer_buffer = self->frames[self->frame].transbuf,
+            .offset          = src_offset
+        },
+        .dst = *region
+    };
+
+    return transmem;
+}
+
+void FG_StagingFlush(FG_Staging *self, SDL_GPUCopyPass *cpypass)
+{
+    Uint32 i = 0;
+
+    if (self->transmem) {
+        SDL_UnmapGPUTransferBuffer(self->device, self->frames[self->frame].transbuf);
+        self->transmem = NULL;
+    }
+
+    for (i = 0; i != self->buffer_count; ++i) {
+        SDL_UploadToGPUBuffer(
+            cpypass,
+            &self->buffer_uploads[i].src,
+            &self->buffer_uploads[i].dst,
+            false
+        );
+    }
+
+    for (i = 0; i != self->texture_count; ++i) {
+        SDL_UploadToGPUTexture(
+            cpypass,
+            &self->texture_uploads[i].src,
+            &self->texture_uploads[i].dst,
+            false
+        );
+    }
+
+    FG_StagingReset(self);
+}
+
+bool FG_StagingSubmit(FG_Staging *self, SDL_GPUCommandBuffer *cmdbuf)
+{
+    FG_StagingFrame *frame = self->frames + self->frame;
+
+    frame->fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdbuf);
+    if (!frame->fence) return false;
+
+    frame->token = ++self->token;
+
+    return true;
+}
+
+Uint64 FG_StagingGetToken(const FG_Staging *self)
+{
+    return self->token;
+}
+
+bool FG_StagingQuery(FG_Staging *self, Uint64 token)
+{
+    Uint8 i = 0;
+
+    if (self->token < token) return false;
+
+    for (i = 0; i != FG_FRAMES_IN_FLIGHT; ++i) {
+        if (self->frames[i].token == token && self->frames[i].fence) {
+            return SDL_QueryGPUFence(self->device, self->frames[i].fence);
+        }
+    }
+
+    /* the fence was already waited on and released by a later begin */
+    return true;
+}
+
+void FG_DestroyStaging(FG_Staging *self)
+{
+    Uint8 i = 0;
+
+    if (!self) return;
+    FG_StagingReset(self);
+    SDL_free(self->retirees);
+    SDL_free(self->texture_uploads);
+    SDL_free(self->buffer_uploads);
+    for (i = 0; i != FG_FRAMES_IN_FLIGHT; ++i) {
+        SDL_ReleaseGPUFence(self->device, self->frames[i].fence);
+        SDL_ReleaseGPUTransferBuffer(self->device, self->frames[i].transbuf);
+    }
+    SDL_free(self);
+}
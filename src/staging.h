@@ -0,0 +1,57 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_STAGING_H
+#define FLYGPU_STAGING_H
+
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+
+typedef struct FG_Staging FG_Staging;
+
+FG_Staging * FG_CreateStaging(SDL_GPUDevice *device);
+
+bool FG_StagingBegin(FG_Staging *self);
+
+void * FG_StagingUploadToBuffer(FG_Staging    *self,
+                                SDL_GPUBuffer *buffer,
+                                Uint32         offset,
+                                Uint32         size);
+
+void * FG_StagingUploadToTexture(FG_Staging                 *self,
+                                 const SDL_GPUTextureRegion *region,
+                                 Uint32                      size);
+
+void FG_StagingFlush(FG_Staging *self, SDL_GPUCopyPass *cpypass);
+
+bool FG_StagingSubmit(FG_Staging *self, SDL_GPUCommandBuffer *cmdbuf);
+
+Uint64 FG_StagingGetToken(const FG_Staging *self);
+
+bool FG_StagingQuery(FG_Staging *self, Uint64 token);
+
+void FG_DestroyStaging(FG_Staging *self);
+
+#endif /* FLYGPU_STAGING_H */
@@ -0,0 +1,225 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "uploads.h"
+
+#include "staging.h"
+
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_mutex.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct FG_Uploads
+{
+    SDL_GPUDevice   *device;
+    FG_Staging      *staging;
+    SDL_Mutex       *mutex;
+    Uint32           mipmap_capacity;
+    Uint32           mipmap_count;
+    SDL_GPUTexture **mipmaps;
+    bool             pending;
+    Uint8            padding[7];
+};
+
+static bool FG_UploadsBegin(FG_Uploads *self);
+
+static bool FG_UploadsFlush(FG_Uploads *self, Uint64 *token);
+
+FG_Uploads * FG_CreateUploads(SDL_GPUDevice *device)
+{
+    FG_Uploads *self = SDL_calloc(1, sizeof(*self));
+
+    if (!self) return NULL;
+
+    self->device = device;
+
+    self->mutex = SDL_CreateMutex();
+    if (!self->mutex) {
+        FG_DestroyUploads(self);
+        return NULL;
+    }
+
+    self->staging = FG_CreateStaging(device);
+    if (!self->staging) {
+        FG_DestroyUploads(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+void FG_UploadsLock(FG_Uploads *self)
+{
+    /* SDL mutexes are recursive, so the calls below still lock inside this */
+    SDL_LockMutex(self->mutex);
+}
+
+void FG_UploadsUnlock(FG_Uploads *self)
+{
+    SDL_UnlockMutex(self->mutex);
+}
+
+bool FG_UploadsToTexture(FG_Uploads                 *self,
+                         const SDL_GPUTextureRegion *region,
+                         const void                 *data,
+                         Uint32                      size)
+{
+    void *transmem = NULL;
+
+    SDL_LockMutex(self->mutex);
+
+    if (!FG_UploadsBegin(self)) {
+        SDL_UnlockMutex(self->mutex);
+        return false;
+    }
+
+    /* a growing staging buffer unmaps the old one, so copy before letting go */
+    transmem = FG_StagingUploadToTexture(self->staging, region, size);
+    if (transmem) SDL_memcpy(transmem, data, size);
+
+    SDL_UnlockMutex(self->mutex);
+
+    return transmem;
+}
+
+bool FG_UploadsGenerateMipmaps(FG_Uploads *self, SDL_GPUTexture *texture)
+{
+    Uint32           capacity = 0;
+    SDL_GPUTexture **mipmaps  = NULL;
+
+    SDL_LockMutex(self->mutex);
+
+    /* a batch that was already submitted would otherwise drop the mipmaps */
+    if (!FG_UploadsBegin(self)) {
+        SDL_UnlockMutex(self->mutex);
+        return false;
+    }
+
+    if (self->mipmap_capacity == self->mipmap_count) {
+        capacity = self->mipmap_capacity ? 2 * self->mipmap_capacity : 16;
+
+        mipmaps = SDL_realloc(self->mipmaps, capacity * sizeof(*mipmaps));
+        if (!mipmaps) {
+            SDL_UnlockMutex(self->mutex);
+            return false;
+        }
+
+        self->mipmaps         = mipmaps;
+        self->mipmap_capacity = capacity;
+    }
+
+    self->mipmaps[self->mipmap_count++] = texture;
+
+    SDL_UnlockMutex(self->mutex);
+
+    return true;
+}
+
+bool FG_UploadsSubmit(FG_Uploads *self, Uint64 *token)
+{
+    bool result = false;
+
+    SDL_LockMutex(self->mutex);
+    result = FG_UploadsFlush(self, token);
+    SDL_UnlockMutex(self->mutex);
+
+    return result;
+}
+
+bool FG_UploadsTrySubmit(FG_Uploads *self)
+{
+    bool result = false;
+
+    /* a worker mid-upload keeps its batch open, so it goes out on a later call */
+    if (!SDL_TryLockMutex(self->mutex)) return true;
+
+    result = FG_UploadsFlush(self, NULL);
+    SDL_UnlockMutex(self->mutex);
+
+    return result;
+}
+
+bool FG_UploadsQuery(FG_Uploads *self, Uint64 token)
+{
+    bool result = false;
+
+    SDL_LockMutex(self->mutex);
+    result = FG_StagingQuery(self->staging, token);
+    SDL_UnlockMutex(self->mutex);
+
+    return result;
+}
+
+bool FG_UploadsBegin(FG_Uploads *self)
+{
+    /* the first upload of a batch waits only if every staging frame is in flight */
+    if (self->pending) return true;
+
+    if (!FG_StagingBegin(self->staging)) return false;
+
+    self->pending = true;
+
+    return true;
+}
+
+bool FG_UploadsFlush(FG_Uploads *self, Uint64 *token)
+{
+    SDL_GPUCommandBuffer *cmdbuf  = NULL;
+    SDL_GPUCopyPass      *cpypass = NULL;
+    Uint32                i       = 0;
+    bool                  result  = true;
+
+    if (self->pending) {
+        cmdbuf = SDL_AcquireGPUCommandBuffer(self->device);
+        if (!cmdbuf) return false;
+
+        cpypass = SDL_BeginGPUCopyPass(cmdbuf);
+        FG_StagingFlush(self->staging, cpypass);
+        SDL_EndGPUCopyPass(cpypass);
+
+        for (i = 0; i != self->mipmap_count; ++i) {
+            SDL_GenerateMipmapsForGPUTexture(cmdbuf, self->mipmaps[i]);
+        }
+
+        self->mipmap_count = 0;
+        self->pending      = false;
+
+        result = FG_StagingSubmit(self->staging, cmdbuf);
+    }
+
+    if (token) *token = FG_StagingGetToken(self->staging);
+
+    return result;
+}
+
+void FG_DestroyUploads(FG_Uploads *self)
+{
+    if (!self) return;
+    FG_DestroyStaging(self->staging);
+    SDL_DestroyMutex(self->mutex);
+    SDL_free(self->mipmaps);
+    SDL_free(self);
+}
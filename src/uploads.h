@@ -0,0 +1,55 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef FLYGPU_UPLOADS_H
+#define FLYGPU_UPLOADS_H
+
+#include <SDL3/SDL_gpu.h>
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+
+typedef struct FG_Uploads FG_Uploads;
+
+FG_Uploads * FG_CreateUploads(SDL_GPUDevice *device);
+
+void FG_UploadsLock(FG_Uploads *self);
+
+void FG_UploadsUnlock(FG_Uploads *self);
+
+bool FG_UploadsToTexture(FG_Uploads                 *self,
+                         const SDL_GPUTextureRegion *region,
+                         const void                 *data,
+                         Uint32                      size);
+
+bool FG_UploadsGenerateMipmaps(FG_Uploads *self, SDL_GPUTexture *texture);
+
+bool FG_UploadsSubmit(FG_Uploads *self, Uint64 *token);
+
+bool FG_UploadsTrySubmit(FG_Uploads *self);
+
+bool FG_UploadsQuery(FG_Uploads *self, Uint64 token);
+
+void FG_DestroyUploads(FG_Uploads *self);
+
+#endif /* FLYGPU_UPLOADS_H */
@@ -0,0 +1,201 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../include/flygpu/flygpu.h"
+#include "../src/dds.h"
+#include "../src/pack.h"
+
+#include <SDL3/SDL_endian.h>
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_stdinc.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef struct
+{
+    FG_PackEntry        entry;
+    FG_CompressedImage *image;
+} Asset;
+
+static Sint32 SDLCALL AssetComparator(const void *lhs, const void *rhs);
+
+static Uint64 GetImageSize(const FG_CompressedImage *image);
+
+static bool WriteZeros(SDL_IOStream *dst, Uint64 count);
+
+Sint32 AssetComparator(const void *lhs, const void *rhs)
+{
+    return SDL_strcmp(
+        ((const Asset *)lhs)->entry.name, ((const Asset *)rhs)->entry.name);
+}
+
+Uint64 GetImageSize(const FG_CompressedImage *image)
+{
+    Uint64 size = 0;
+    Uint32 i    = 0;
+
+    for (i = 0; i != image->level_count; ++i) {
+        size += FG_GetCompressedLevelSize(image->width, image->height, i);
+    }
+
+    return size;
+}
+
+bool WriteZeros(SDL_IOStream *dst, Uint64 count)
+{
+    for (; count; --count) {
+        if (!SDL_WriteU8(dst, 0)) return false;
+    }
+
+    return true;
+}
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    Uint32                    count    = argc < 3 ? 0 : (Uint32)argc - 2;
+    Asset                    *assets   = NULL;
+    const char               *path     = NULL;
+    size_t                    length   = 0;
+    const FG_CompressedImage *image    = NULL;
+    Uint64                    offset   = 0;
+    FG_PackHeader             header   = { 0 };
+    SDL_IOStream             *dst      = NULL;
+    Uint64                    position = 0;
+    Uint64                    size     = 0;
+    Uint32                    i        = 0;
+
+    if (!count) {
+        SDL_Log("Usage: %s OUTPUT.fgpak NAME=INPUT.dds...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    assets = SDL_calloc(count, sizeof(*assets));
+    if (!assets) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i != count; ++i) {
+        path = SDL_strchr(argv[i + 2], '=');
+        if (!path) {
+            SDL_LogError(
+                SDL_LOG_CATEGORY_ERROR, "%s: expected NAME=INPUT.dds\n", argv[i + 2]);
+            return EXIT_FAILURE;
+        }
+
+        length = (size_t)(path - argv[i + 2]);
+        if (!length || FG_PACK_NAME_SIZE <= length) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+                         "%s: name must be 1 to %d characters\n",
+                         argv[i + 2],
+                         FG_PACK_NAME_SIZE - 1);
+            return EXIT_FAILURE;
+        }
+
+        SDL_memcpy(assets[i].entry.name, argv[i + 2], length);
+
+        assets[i].image = FG_LoadDDS(path + 1);
+        if (!assets[i].image) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s: %s\n", path + 1, SDL_GetError());
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* sorted by name, the runtime finds entries with a binary search */
+    SDL_qsort(assets, count, sizeof(*assets), AssetComparator);
+
+    offset = sizeof(header) + count * sizeof(assets->entry);
+
+    for (i = 0; i != count; ++i) {
+        if (i && !SDL_strcmp(assets[i - 1].entry.name, assets[i].entry.name)) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR,
+                         "%s: name is used more than once\n",
+                         assets[i].entry.name);
+            return EXIT_FAILURE;
+        }
+
+        offset = (offset + FG_PACK_ALIGNMENT - 1) & ~(Uint64)(FG_PACK_ALIGNMENT - 1);
+
+        image = assets[i].image;
+
+        assets[i].entry.compression = SDL_Swap32LE((Uint32)image->compression);
+        assets[i].entry.width       = SDL_Swap32LE(image->width);
+        assets[i].entry.height      = SDL_Swap32LE(image->height);
+        assets[i].entry.level_count = SDL_Swap32LE(image->level_count);
+        assets[i].entry.offset      = SDL_Swap64LE(offset);
+        assets[i].entry.size        = SDL_Swap64LE(GetImageSize(image));
+
+        offset += SDL_Swap64LE(assets[i].entry.size);
+    }
+
+    header.magic   = SDL_Swap32LE(FG_PACK_MAGIC);
+    header.version = SDL_Swap32LE(FG_PACK_VERSION);
+    header.count   = SDL_Swap32LE(count);
+
+    dst = SDL_IOFromFile(argv[1], "wb");
+    if (!dst || SDL_WriteIO(dst, &header, sizeof(header)) != sizeof(header)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    for (i = 0; i != count; ++i) {
+        if (SDL_WriteIO(dst, &assets[i].entry, sizeof(assets[i].entry)) !=
+            sizeof(assets[i].entry)
+        ) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+            return EXIT_FAILURE;
+        }
+    }
+
+    position = sizeof(header) + count * sizeof(assets->entry);
+
+    for (i = 0; i != count; ++i) {
+        offset = SDL_Swap64LE(assets[i].entry.offset);
+        size   = SDL_Swap64LE(assets[i].entry.size);
+
+        if (!WriteZeros(dst, offset - position) ||
+            SDL_WriteIO(dst, assets[i].image->levels, size) != size
+        ) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+            return EXIT_FAILURE;
+        }
+
+        position = offset + size;
+
+        SDL_free(assets[i].image);
+    }
+
+    SDL_free(assets);
+
+    if (!SDL_CloseIO(dst)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
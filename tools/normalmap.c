@@ -0,0 +1,158 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_surface.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define CHANNELS 4
+#define STRENGTH 2.0F
+
+static float GetHeight(const float *heights,
+                       Uint32       width,
+                       Uint32       height,
+                       Sint32       x,
+                       Sint32       y);
+
+static Uint8 EncodeAxis(float value);
+
+float GetHeight(const float *heights,
+                Uint32       width,
+                Uint32       height,
+                Sint32       x,
+                Sint32       y)
+{
+    /* the materials tile, so the filter wraps around the edges */
+    return heights[
+        ((Uint32)(y + (Sint32)height) % height) * width
+        + (Uint32)(x + (Sint32)width) % width
+    ];
+}
+
+Uint8 EncodeAxis(float value)
+{
+    return (Uint8)(SDL_clamp(0.5F * value + 0.5F, 0.0F, 1.0F) * 255.0F + 0.5F);
+}
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    SDL_Surface *loaded  = NULL;
+    SDL_Surface *surface = NULL;
+    SDL_Surface *normals = NULL;
+    float       *heights = NULL;
+    Uint32       width   = 0;
+    Uint32       height  = 0;
+    const Uint8 *texel   = NULL;
+    Uint8       *normal  = NULL;
+    float        dx      = 0.0F;
+    float        dy      = 0.0F;
+    float        length  = 0.0F;
+    Sint32       x       = 0;
+    Sint32       y       = 0;
+
+    if (argc != 3) {
+        SDL_Log("Usage: %s ALBEDO.png NORMAL.png\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    loaded = SDL_LoadPNG(argv[1]);
+    if (!loaded) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    surface = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_ABGR8888);
+    SDL_DestroySurface(loaded);
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    width   = (Uint32)surface->w;
+    height  = (Uint32)surface->h;
+    heights = SDL_malloc(width * height * sizeof(*heights));
+    normals = SDL_CreateSurface(surface->w, surface->h, SDL_PIXELFORMAT_ABGR8888);
+    if (!heights || !normals) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    /* the albedo's luminance stands in for the height of the surface */
+    for (y = 0; y != surface->h; ++y) {
+        for (x = 0; x != surface->w; ++x) {
+            texel = (const Uint8 *)surface->pixels
+                  + y * surface->pitch + CHANNELS * x;
+
+            heights[(Uint32)y * width + (Uint32)x] = (
+                0.2126F * texel[0] + 0.7152F * texel[1] + 0.0722F * texel[2]
+            ) / 255.0F;
+        }
+    }
+
+    SDL_DestroySurface(surface);
+
+    for (y = 0; y != normals->h; ++y) {
+        for (x = 0; x != normals->w; ++x) {
+            dx = GetHeight(heights, width, height, x + 1, y - 1)
+               + 2.0F * GetHeight(heights, width, height, x + 1, y)
+               + GetHeight(heights, width, height, x + 1, y + 1)
+               - GetHeight(heights, width, height, x - 1, y - 1)
+               - 2.0F * GetHeight(heights, width, height, x - 1, y)
+               - GetHeight(heights, width, height, x - 1, y + 1);
+            dy = GetHeight(heights, width, height, x - 1, y + 1)
+               + 2.0F * GetHeight(heights, width, height, x, y + 1)
+               + GetHeight(heights, width, height, x + 1, y + 1)
+               - GetHeight(heights, width, height, x - 1, y - 1)
+               - 2.0F * GetHeight(heights, width, height, x, y - 1)
+               - GetHeight(heights, width, height, x + 1, y - 1);
+
+            dx     *= -STRENGTH;
+            dy     *= STRENGTH;
+            length  = SDL_sqrtf(dx * dx + dy * dy + 1.0F);
+            normal  = (Uint8 *)normals->pixels + y * normals->pitch + CHANNELS * x;
+
+            normal[0] = EncodeAxis(dx / length);
+            normal[1] = EncodeAxis(dy / length);
+            normal[2] = EncodeAxis(1.0F / length);
+            normal[3] = 255;
+        }
+    }
+
+    SDL_free(heights);
+
+    if (!SDL_SavePNG(normals, argv[2])) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    SDL_DestroySurface(normals);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,578 @@
+/* clang-format off */
+
+/*
+  FlyGPU
+  Copyright (C) 2025-2026 Domán Zana
+
+  This software is provided 'as-is', without any express or implied
+  warranty. In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../src/dds.h"
+
+#include <SDL3/SDL_error.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_main.h>     /* IWYU pragma: keep */
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_surface.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#define TEXEL_COUNT (FG_BLOCK_DIM * FG_BLOCK_DIM)
+#define CHANNELS    4
+
+typedef struct
+{
+    Uint32 width;
+    Uint32 height;
+    Uint8 *texels;
+} Level;
+
+typedef struct
+{
+    Uint8  bytes[FG_BLOCK_SIZE];
+    Uint32 position;
+} BitWriter;
+
+static const char *const FORMAT_NAMES[] = { "bc3", "bc5", "bc7" };
+
+static const Uint32 FORMATS[SDL_arraysize(FORMAT_NAMES)] = {
+    FG_DXGI_FORMAT_BC3_UNORM,
+    FG_DXGI_FORMAT_BC5_UNORM,
+    FG_DXGI_FORMAT_BC7_UNORM
+};
+
+static const Uint32 BC7_WEIGHTS[16] = {
+    0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+
+static void FetchBlock(const Level *level,
+                       Uint32       x,
+                       Uint32       y,
+                       float        texels[TEXEL_COUNT][CHANNELS]);
+
+static void FitLine(const float texels[TEXEL_COUNT][CHANNELS],
+                    Uint32      channels,
+                    float       lo[CHANNELS],
+                    float       hi[CHANNELS]);
+
+static void WriteBits(BitWriter *writer, Uint32 value, Uint32 count);
+
+static void EncodeBC4(const float texels[TEXEL_COUNT][CHANNELS],
+                      Uint32      channel,
+                      Uint8      *block);
+
+static void EncodeBC1(const float texels[TEXEL_COUNT][CHANNELS], Uint8 *block);
+
+static void EncodeBC7(const float texels[TEXEL_COUNT][CHANNELS], Uint8 *block);
+
+static bool Downsample(const Level *src, Level *dst);
+
+static bool WriteDDS(SDL_IOStream *dst, Uint32 format, const Level *level);
+
+void FetchBlock(const Level *level,
+                Uint32       x,
+                Uint32       y,
+                float        texels[TEXEL_COUNT][CHANNELS])
+{
+    Uint32       i     = 0;
+    Uint32       j     = 0;
+    const Uint8 *texel = NULL;
+
+    /* levels below the top may end mid-block, so their edges are repeated */
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        texel = level->texels + CHANNELS * (
+            SDL_min(y + i / FG_BLOCK_DIM, level->height - 1) * level->width
+            + SDL_min(x + i % FG_BLOCK_DIM, level->width - 1)
+        );
+
+        for (j = 0; j != CHANNELS; ++j) texels[i][j] = (float)texel[j];
+    }
+}
+
+void FitLine(const float texels[TEXEL_COUNT][CHANNELS],
+             Uint32      channels,
+             float       lo[CHANNELS],
+             float       hi[CHANNELS])
+{
+    float  mean[CHANNELS]                 = { 0 };
+    float  covariance[CHANNELS][CHANNELS] = { { 0 } };
+    float  axis[CHANNELS]                 = { 1.0F, 1.0F, 1.0F, 1.0F };
+    float  next[CHANNELS]                 = { 0 };
+    float  length                         = 0.0F;
+    float  projection                     = 0.0F;
+    float  min                            = 0.0F;
+    float  max                            = 0.0F;
+    Uint32 i                              = 0;
+    Uint32 j                              = 0;
+    Uint32 k                              = 0;
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        for (j = 0; j != channels; ++j) mean[j] += texels[i][j] / TEXEL_COUNT;
+    }
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        for (j = 0; j != channels; ++j) {
+            for (k = 0; k != channels; ++k) {
+                covariance[j][k] += (texels[i][j] - mean[j])
+                                  * (texels[i][k] - mean[k]);
+            }
+        }
+    }
+
+    /* the principal axis by power iteration, which a handful of steps settles */
+    for (i = 0; i != 8; ++i) {
+        length = 0.0F;
+        for (j = 0; j != channels; ++j) {
+            next[j] = 0.0F;
+            for (k = 0; k != channels; ++k) next[j] += covariance[j][k] * axis[k];
+            length += next[j] * next[j];
+        }
+
+        if (length <= 1e-12F) {
+            for (j = 0; j != channels; ++j) lo[j] = hi[j] = mean[j];
+            return;
+        }
+
+        length = SDL_sqrtf(length);
+        for (j = 0; j != channels; ++j) axis[j] = next[j] / length;
+    }
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        projection = 0.0F;
+        for (j = 0; j != channels; ++j) {
+            projection += (texels[i][j] - mean[j]) * axis[j];
+        }
+
+        min = i ? SDL_min(min, projection) : projection;
+        max = i ? SDL_max(max, projection) : projection;
+    }
+
+    for (j = 0; j != channels; ++j) {
+        lo[j] = SDL_clamp(mean[j] + min * axis[j], 0.0F, 255.0F);
+        hi[j] = SDL_clamp(mean[j] + max * axis[j], 0.0F, 255.0F);
+    }
+}
+
+void WriteBits(BitWriter *writer, Uint32 value, Uint32 count)
+{
+    Uint32 i = 0;
+
+    for (i = 0; i != count; ++i, ++writer->position) {
+        writer->bytes[writer->position / 8] |= (Uint8)(
+            ((value >> i) & 1) << (writer->position % 8));
+    }
+}
+
+void EncodeBC4(const float texels[TEXEL_COUNT][CHANNELS],
+               Uint32      channel,
+               Uint8      *block)
+{
+    float     palette[8] = { 0 };
+    float     min        = texels[0][channel];
+    float     max        = texels[0][channel];
+    float     error      = 0.0F;
+    float     best_error = 0.0F;
+    Uint32    best       = 0;
+    Uint32    i          = 0;
+    Uint32    j          = 0;
+    bool      flat       = false;
+    BitWriter writer     = { { 0 }, 0 };
+
+    for (i = 1; i != TEXEL_COUNT; ++i) {
+        min = SDL_min(min, texels[i][channel]);
+        max = SDL_max(max, texels[i][channel]);
+    }
+
+    /* equal endpoints would select the six value mode, so every index stays 0 */
+    flat = SDL_lroundf(max) == SDL_lroundf(min);
+
+    /* the first endpoint above the second selects eight interpolated values */
+    WriteBits(&writer, (Uint32)SDL_lroundf(max), 8);
+    WriteBits(&writer, (Uint32)SDL_lroundf(min), 8);
+
+    palette[0] = SDL_roundf(max);
+    palette[1] = SDL_roundf(min);
+    for (i = 2; i != SDL_arraysize(palette); ++i) {
+        palette[i] = ((float)(8 - i) * palette[0] + (float)(i - 1) * palette[1])
+                   / 7.0F;
+    }
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        best = 0;
+        for (j = 0; !flat && j != SDL_arraysize(palette); ++j) {
+            error = SDL_fabsf(palette[j] - texels[i][channel]);
+            if (!j || error < best_error) {
+                best       = j;
+                best_error = error;
+            }
+        }
+
+        WriteBits(&writer, best, 3);
+    }
+
+    SDL_memcpy(block, writer.bytes, FG_BLOCK_SIZE / 2);
+}
+
+void EncodeBC1(const float texels[TEXEL_COUNT][CHANNELS], Uint8 *block)
+{
+    float     lo[CHANNELS]  = { 0 };
+    float     hi[CHANNELS]  = { 0 };
+    Uint32    endpoints[2]  = { 0 };
+    float     palette[4][3] = { { 0 } };
+    Uint32    swap          = 0;
+    float     error         = 0.0F;
+    float     best_error    = 0.0F;
+    Uint32    best          = 0;
+    Uint32    i             = 0;
+    Uint32    j             = 0;
+    Uint32    k             = 0;
+    BitWriter writer        = { { 0 }, 0 };
+
+    FitLine(texels, 3, lo, hi);
+
+    endpoints[0] = (Uint32)SDL_lroundf(hi[0] * 31.0F / 255.0F) << 11
+                 | (Uint32)SDL_lroundf(hi[1] * 63.0F / 255.0F) << 5
+                 | (Uint32)SDL_lroundf(hi[2] * 31.0F / 255.0F);
+    endpoints[1] = (Uint32)SDL_lroundf(lo[0] * 31.0F / 255.0F) << 11
+                 | (Uint32)SDL_lroundf(lo[1] * 63.0F / 255.0F) << 5
+                 | (Uint32)SDL_lroundf(lo[2] * 31.0F / 255.0F);
+
+    /* keep the first endpoint larger, which older decoders read as four colors */
+    if (endpoints[0] < endpoints[1]) {
+        swap         = endpoints[0];
+        endpoints[0] = endpoints[1];
+        endpoints[1] = swap;
+    }
+
+    for (i = 0; i != 2; ++i) {
+        palette[i][0] = (float)((endpoints[i] >> 11) << 3 | (endpoints[i] >> 13));
+        palette[i][1] = (float)((endpoints[i] >> 5 & 0x3F) << 2
+                                | (endpoints[i] >> 9 & 0x3));
+        palette[i][2] = (float)((endpoints[i] & 0x1F) << 3
+                                | (endpoints[i] >> 2 & 0x7));
+    }
+
+    for (j = 0; j != 3; ++j) {
+        palette[2][j] = (2.0F * palette[0][j] + palette[1][j]) / 3.0F;
+        palette[3][j] = (palette[0][j] + 2.0F * palette[1][j]) / 3.0F;
+    }
+
+    WriteBits(&writer, endpoints[0], 16);
+    WriteBits(&writer, endpoints[1], 16);
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        best = 0;
+        for (j = 0; endpoints[0] != endpoints[1] && j != 4; ++j) {
+            error = 0.0F;
+            for (k = 0; k != 3; ++k) {
+                error += (palette[j][k] - texels[i][k])
+                       * (palette[j][k] - texels[i][k]);
+            }
+
+            if (!j || error < best_error) {
+                best       = j;
+                best_error = error;
+            }
+        }
+
+        WriteBits(&writer, best, 2);
+    }
+
+    SDL_memcpy(block, writer.bytes, FG_BLOCK_SIZE / 2);
+}
+
+/* mode 6 only: one subset of RGBA with 7 bit endpoints, p-bits and 4 bit indices */
+void EncodeBC7(const float texels[TEXEL_COUNT][CHANNELS], Uint8 *block)
+{
+    float     line[2][CHANNELS]      = { { 0 } };
+    Uint32    endpoints[2][CHANNELS] = { { 0 } };
+    Uint32    pbits[2]               = { 0 };
+    Uint32    palette[16][CHANNELS]  = { { 0 } };
+    Uint32    indices[TEXEL_COUNT]   = { 0 };
+    Uint32    quantized[CHANNELS]    = { 0 };
+    Uint32    swap                   = 0;
+    float     error                  = 0.0F;
+    float     best_error             = 0.0F;
+    Uint32    i                      = 0;
+    Uint32    j                      = 0;
+    Uint32    k                      = 0;
+    Uint32    p                      = 0;
+    BitWriter writer                 = { { 0 }, 0 };
+
+    FitLine(texels, CHANNELS, line[0], line[1]);
+
+    for (i = 0; i != 2; ++i) {
+        for (p = 0; p != 2; ++p) {
+            error = 0.0F;
+            for (j = 0; j != CHANNELS; ++j) {
+                quantized[j] = (Uint32)SDL_clamp(
+                    SDL_lroundf((line[i][j] - (float)p) / 2.0F), 0, 127);
+                error += ((float)(quantized[j] << 1 | p) - line[i][j])
+                       * ((float)(quantized[j] << 1 | p) - line[i][j]);
+            }
+
+            if (!p || error < best_error) {
+                best_error = error;
+                pbits[i]   = p;
+                SDL_memcpy(endpoints[i], quantized, sizeof(quantized));
+            }
+        }
+    }
+
+    for (i = 0; i != 16; ++i) {
+        for (j = 0; j != CHANNELS; ++j) {
+            palette[i][j] = ((64 - BC7_WEIGHTS[i]) * (endpoints[0][j] << 1 | pbits[0])
+                             + BC7_WEIGHTS[i] * (endpoints[1][j] << 1 | pbits[1])
+                             + 32) >> 6;
+        }
+    }
+
+    for (i = 0; i != TEXEL_COUNT; ++i) {
+        for (j = 0; j != 16; ++j) {
+            error = 0.0F;
+            for (k = 0; k != CHANNELS; ++k) {
+                error += ((float)palette[j][k] - texels[i][k])
+                       * ((float)palette[j][k] - texels[i][k]);
+            }
+
+            if (!j || error < best_error) {
+                indices[i] = j;
+                best_error = error;
+            }
+        }
+    }
+
+    /* the first index drops its top bit, so mirror the endpoints when it is set */
+    if (8 <= indices[0]) {
+        for (j = 0; j != CHANNELS; ++j) {
+            swap            = endpoints[0][j];
+            endpoints[0][j] = endpoints[1][j];
+            endpoints[1][j] = swap;
+        }
+
+        swap     = pbits[0];
+        pbits[0] = pbits[1];
+        pbits[1] = swap;
+
+        for (i = 0; i != TEXEL_COUNT; ++i) indices[i] = 15 - indices[i];
+    }
+
+    WriteBits(&writer, 1 << 6, 7);
+
+    for (j = 0; j != CHANNELS; ++j) {
+        WriteBits(&writer, endpoints[0][j], 7);
+        WriteBits(&writer, endpoints[1][j], 7);
+    }
+
+    WriteBits(&writer, pbits[0], 1);
+    WriteBits(&writer, pbits[1], 1);
+
+    for (i = 0; i != TEXEL_COUNT; ++i) WriteBits(&writer, indices[i], i ? 4 : 3);
+
+    SDL_memcpy(block, writer.bytes, FG_BLOCK_SIZE);
+}
+
+bool Downsample(const Level *src, Level *dst)
+{
+    Uint32 x     = 0;
+    Uint32 y     = 0;
+    Uint32 i     = 0;
+    Uint32 sum   = 0;
+    Uint32 left  = 0;
+    Uint32 right = 0;
+    Uint32 top   = 0;
+    Uint32 down  = 0;
+
+    dst->width  = SDL_max(src->width / 2, 1);
+    dst->height = SDL_max(src->height / 2, 1);
+
+    dst->texels = SDL_malloc(CHANNELS * dst->width * dst->height);
+    if (!dst->texels) return false;
+
+    for (y = 0; y != dst->height; ++y) {
+        top  = SDL_min(2 * y, src->height - 1) * src->width;
+        down = SDL_min(2 * y + 1, src->height - 1) * src->width;
+
+        for (x = 0; x != dst->width; ++x) {
+            left  = SDL_min(2 * x, src->width - 1);
+            right = SDL_min(2 * x + 1, src->width - 1);
+
+            for (i = 0; i != CHANNELS; ++i) {
+                sum = (Uint32)src->texels[CHANNELS * (top + left) + i]
+                    + src->texels[CHANNELS * (top + right) + i]
+                    + src->texels[CHANNELS * (down + left) + i]
+                    + src->texels[CHANNELS * (down + right) + i];
+
+                dst->texels[CHANNELS * (y * dst->width + x) + i] = (Uint8)(
+                    (sum + 2) / 4);
+            }
+        }
+    }
+
+    return true;
+}
+
+bool WriteDDS(SDL_IOStream *dst, Uint32 format, const Level *level)
+{
+    Uint32 words[FG_DDS_WORD_COUNT] = { 0 };
+    Uint32 i                        = 0;
+
+    words[FG_DDS_WORD_MAGIC]     = FG_DDS_MAGIC;
+    words[FG_DDS_WORD_SIZE]      = FG_DDS_HEADER_SIZE;
+    words[FG_DDS_WORD_FLAGS]     = FG_DDS_FLAGS;
+    words[FG_DDS_WORD_HEIGHT]    = level->height;
+    words[FG_DDS_WORD_WIDTH]     = level->width;
+    words[FG_DDS_WORD_PITCH]     = FG_GetCompressedLevelSize(
+        level->width, level->height, 0);
+    words[FG_DDS_WORD_PF_SIZE]   = FG_DDS_FORMAT_SIZE;
+    words[FG_DDS_WORD_PF_FLAGS]  = FG_DDS_FOURCC;
+    words[FG_DDS_WORD_PF_FOURCC] = FG_DDS_DX10;
+    words[FG_DDS_WORD_CAPS]      = FG_DDS_CAPS;
+    words[FG_DDS_WORD_FORMAT]    = format;
+    words[FG_DDS_WORD_DIMENSION] = FG_DDS_DIMENSION_2D;
+    words[FG_DDS_WORD_ARRAY]     = 1;
+
+    while (SDL_max(level->width, level->height) >> words[FG_DDS_WORD_LEVELS]) {
+        ++words[FG_DDS_WORD_LEVELS];
+    }
+
+    for (i = 0; i != FG_DDS_WORD_COUNT; ++i) {
+        if (!SDL_WriteU32LE(dst, words[i])) return false;
+    }
+
+    return true;
+}
+
+Sint32 main(Sint32 argc, char **argv)
+{
+    Uint32        format                        = SDL_arraysize(FORMATS);
+    SDL_Surface  *loaded                        = NULL;
+    SDL_Surface  *surface                       = NULL;
+    Level         level                         = { 0 };
+    Level         next                          = { 0 };
+    SDL_IOStream *dst                           = NULL;
+    float         texels[TEXEL_COUNT][CHANNELS] = { { 0 } };
+    Uint8         block[FG_BLOCK_SIZE]          = { 0 };
+    Uint32        x                             = 0;
+    Uint32        y                             = 0;
+    Uint32        i                             = 0;
+
+    for (i = 0; argc == 4 && i != SDL_arraysize(FORMAT_NAMES); ++i) {
+        if (!SDL_strcmp(argv[1], FORMAT_NAMES[i])) format = i;
+    }
+
+    if (SDL_arraysize(FORMATS) == format) {
+        SDL_Log("Usage: %s bc3|bc5|bc7 INPUT.png OUTPUT.dds\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    loaded = SDL_LoadPNG(argv[2]);
+    if (!loaded) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    surface = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_ABGR8888);
+    SDL_DestroySurface(loaded);
+    if (!surface) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    /* the top level is padded to whole blocks by repeating the last row and column */
+    level.width  = ((Uint32)surface->w + FG_BLOCK_DIM - 1) & ~(FG_BLOCK_DIM - 1U);
+    level.height = ((Uint32)surface->h + FG_BLOCK_DIM - 1) & ~(FG_BLOCK_DIM - 1U);
+    level.texels = SDL_malloc(CHANNELS * level.width * level.height);
+    if (!level.texels) {
+        SDL_DestroySurface(surface);
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    for (y = 0; y != level.height; ++y) {
+        for (x = 0; x != level.width; ++x) {
+            SDL_memcpy(
+                level.texels + CHANNELS * (y * level.width + x),
+                (const Uint8 *)surface->pixels
+                + SDL_min(y, (Uint32)surface->h - 1) * (Uint32)surface->pitch
+                + CHANNELS * SDL_min(x, (Uint32)surface->w - 1),
+                CHANNELS
+            );
+        }
+    }
+
+    if (level.width != (Uint32)surface->w || level.height != (Uint32)surface->h) {
+        SDL_Log("%s: padded %dx%d to %ux%u\n",
+                argv[2], surface->w, surface->h, level.width, level.height);
+    }
+
+    SDL_DestroySurface(surface);
+
+    dst = SDL_IOFromFile(argv[3], "wb");
+    if (!dst || !WriteDDS(dst, FORMATS[format], &level)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    while (true) {
+        for (y = 0; y < level.height; y += FG_BLOCK_DIM) {
+            for (x = 0; x < level.width; x += FG_BLOCK_DIM) {
+                FetchBlock(&level, x, y, texels);
+
+                if (FORMATS[format] == FG_DXGI_FORMAT_BC3_UNORM) {
+                    EncodeBC4(texels, 3, block);
+                    EncodeBC1(texels, block + FG_BLOCK_SIZE / 2);
+                }
+                else if (FORMATS[format] == FG_DXGI_FORMAT_BC5_UNORM) {
+                    EncodeBC4(texels, 0, block);
+                    EncodeBC4(texels, 1, block + FG_BLOCK_SIZE / 2);
+                }
+                else {
+                    EncodeBC7(texels, block);
+                }
+
+                if (SDL_WriteIO(dst, block, sizeof(block)) != sizeof(block)) {
+                    SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+                    return EXIT_FAILURE;
+                }
+            }
+        }
+
+        if (1 == level.width && 1 == level.height) break;
+
+        if (!Downsample(&level, &next)) {
+            SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+            return EXIT_FAILURE;
+        }
+
+        SDL_free(level.texels);
+        level = next;
+    }
+
+    SDL_free(level.texels);
+
+    if (!SDL_CloseIO(dst)) {
+        SDL_LogError(SDL_LOG_CATEGORY_ERROR, "%s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}